@@ -42,10 +42,12 @@
 	standard libraries are linked by default.  Depending on node platform, other standard
 	libraries may need to be directly linked
 	\code
-	#include <cstdio>	// snprintf()
-	#include <cstdlib>	// atoi() and atof()
+	#include <cstring>	// memcpy()
 	#include <cstdint>	// uint8_t, int8_t, uint16_t, ... etc.
+	#include <charconv>	// std::from_chars() and std::to_chars()
 	\endcode
+	\note
+	The Packets Core requires C++17 or later (C++20 for std::span token range accessors)
 
 	@{
 */
@@ -53,25 +55,129 @@
 #include "0_EcoSystemVersions.h"
 
 /*! \def PACKETBUFFER_TOKENCOUNT
-	\brief The number of tokens stored in an interface buffer
+	\brief The default number of tokens stored in an interface buffer
 
 	This is only the count of tokens to be stored.
 	The size in bytes of a buffer depends on other factors like:
 	- the token size
 	- and serialization type (if string or binary)
 
+	Token buffers and packet interfaces take their token capacity as a template
+	parameter, this is its default.  A node may size each interface for its traffic,
+	e.g. a small control port and a high volume telemetry port.
+
 */
 #define PACKETBUFFER_TOKENCOUNT (32)
 
-#define PORTOUTPACK_BUFFERLENGTH (20)
+/*! \def PORTOUTPACK_BUFFERLENGTH
+	\brief The number of packets the default normal priority output queue of a packet port can hold
+
+	Ports may replace their default queue with a queue of any capacity.  It must be a power of 2.
+*/
+#define PORTOUTPACK_BUFFERLENGTH (32)
+
+/*! \def PORTOUTPACK_LANELENGTH
+	\brief The number of packets the default high and low priority output queues of a packet port can hold
+
+	It must be a power of 2.
+*/
+#define PORTOUTPACK_LANELENGTH (8)
+
+/*! \def PACKETREGISTRY_IDCAPACITY
+	\brief The default number of packet IDs a packet registry can map
+
+	Packet IDs 0 through PACKETREGISTRY_IDCAPACITY-1 can be registered.  Registries
+	take their ID capacity as a template parameter, this is its default.
+*/
+#define PACKETREGISTRY_IDCAPACITY (256)
+
+/*! \def PACKETINTERFACE_RXRINGSIZE
+	\brief The number of bytes (or chars) a packet interface receive ring can hold
+
+	Each read from a physical layer driver takes everything available, up to the free space of
+	the ring, and deserialization consumes the ring a packet at a time.  It must be a power of 2.
+*/
+#define PACKETINTERFACE_RXRINGSIZE (1024)
+
+/*! \def PACKETINTERFACE_TXSTAGESIZE
+	\brief The number of bytes (or chars) of serialized packets an interface can stage for a coalesced write
 
+	Interfaces that coalesce output add room for one interface buffer, so a packet that does not
+	fit the staged bytes can always wait for a partial write to complete.
+*/
+#define PACKETINTERFACE_TXSTAGESIZE (2048)
+
+/*! \def PACKETINTERFACE_FRAMECOUNT
+	\brief The number of packets a packet interface frames at once for DeSerializeFrame
+
+	Ports reading in batches handle every framed packet before their next read.
+*/
+#define PACKETINTERFACE_FRAMECOUNT (8)
+
+/*! \def PACKETJOURNAL_BLOCKSIZE
+	\brief The number of record bytes in a block of a packet journal
+
+	Journal writers and readers each buffer one block.  A packet larger than a block,
+	less its record header, can not be journaled.
+*/
+#define PACKETJOURNAL_BLOCKSIZE (65536)
+
+/*! \def PORTEXECUTOR_WORKERCOUNT
+	\brief The most worker threads a port executor can run
+*/
+#define PORTEXECUTOR_WORKERCOUNT (8)
+
+/*! \def PORTEXECUTOR_PORTCAPACITY
+	\brief The most packet ports a worker of a port executor can service
+*/
+#define PORTEXECUTOR_PORTCAPACITY (16)
+
+/*! \def PORTEXECUTOR_CYCLEPERIODMICROS
+	\brief The default cycle period of the workers of a port executor, in microseconds
+
+	Workers sleep out the remainder of each cycle.  A period of 0 yields between cycles instead,
+	for the least latency, but keeps a core busy per worker.
+*/
+#define PORTEXECUTOR_CYCLEPERIODMICROS (100)
+
+/*! \def PACKETEVENTLOOP_PORTCAPACITY
+	\brief The most packet ports an event loop can service
+*/
+#define PACKETEVENTLOOP_PORTCAPACITY (256)
+
+/*! \def ECOSYSTEM_HOST_BIGENDIAN
+	\brief Defined when the node stores multi-byte tokens most significant byte first
+
+	Binary packet interfaces compare the host byte order with their configured
+	wire byte order to decide if token bytes are swapped during serialization.
+	It is detected from the compiler, or may be defined by the build of a node.
+*/
+#if !defined(ECOSYSTEM_HOST_BIGENDIAN) && defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__)
+#if (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+#define ECOSYSTEM_HOST_BIGENDIAN
+#endif
+#endif
+
+// the core is C++17: std::to_chars/std::from_chars, if constexpr, and C++17 constexpr functions
+#if (__cplusplus < 201703L) && !(defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+#error "the Packets API Core requires C++17 or later"
+#endif
+
+// standard headers are included here, ahead of the str() macro of LanguageConstructs
 #include <iostream>		// istream, ostream, and iostream (packet interface objects)
-//#include <cstdint>	// uint8_t, int8_t, uint16_t, ... etc.
+#include <cstring>		// memcpy()
+#include <cstdint>		// uint8_t, int8_t, uint16_t, ... etc.
+#include <charconv>		// std::from_chars(), std::to_chars() (token string codec)
+#include <cmath>		// std::isfinite()
+#include <atomic>		// std::atomic (packet port output queues)
+#include <chrono>		// std::chrono (packet journal timestamps)
+#if (__cplusplus >= 202002L) || (defined(_MSVC_LANG) && _MSVC_LANG >= 202002L)
+#include <span>			// std::span (token range accessors)
+#define ECOSYSTEM_HAS_SPAN
+#endif
 
 
 #pragma region String Packets Require char* and binary-string conversion
-//#include <cstdio>		// snprintf()
-//#include <cstdlib>	// atoi() and atof()
 
 
 /*! \def STRINGBUFFER_TOKENRATIO
@@ -105,7 +211,12 @@
 	For now, encoding is restricted to ASCII so there
 	is a 1-to-1 ratio for bytes to chars.
 */
-#define STRINGBUFFER_CHARCOUNT ((PACKETBUFFER_TOKENCOUNT-1)*STRINGBUFFER_TOKENRATIO+STRINGBUFFER_IDTOKENRATIO)
+#define STRINGBUFFER_CHARCOUNT STRINGBUFFER_CHARCOUNT_OF(PACKETBUFFER_TOKENCOUNT)
+
+/*! \def STRINGBUFFER_CHARCOUNT_OF(tokenCount)
+	\brief The number of characters allocated in a string buffer of tokenCount tokens
+*/
+#define STRINGBUFFER_CHARCOUNT_OF(tokenCount) (((tokenCount)-1)*STRINGBUFFER_TOKENRATIO+STRINGBUFFER_IDTOKENRATIO)
 
 /*! @}*/
 
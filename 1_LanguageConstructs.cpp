@@ -1,4 +1,28 @@
 #include "1_LanguageConstructs.h"
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SPD_SIMD_SSE2
+#include <emmintrin.h>	// _mm_cmpeq_epi8(), _mm_movemask_epi8()
+#endif
+#if defined(__SSSE3__) || defined(__AVX2__)
+#include <immintrin.h>	// _mm_shuffle_epi8(), _mm256_shuffle_epi8()
+#endif
+#if defined(__SSE4_2__) || (defined(_MSC_VER) && defined(__AVX__))
+#define SPD_SIMD_CRC32C
+#include <nmmintrin.h>	// _mm_crc32_u8(), _mm_crc32_u32(), _mm_crc32_u64()
+#endif
+#if defined(_MSC_VER)
+#include <cstdlib>		// _byteswap_ushort(), _byteswap_ulong(), _byteswap_uint64()
+#include <intrin.h>		// _BitScanForward()
+#define SPD_BSWAP16(x) _byteswap_ushort(x)
+#define SPD_BSWAP32(x) _byteswap_ulong(x)
+#define SPD_BSWAP64(x) _byteswap_uint64(x)
+static inline int SPD_CTZ32(uint32_t x) { unsigned long i; _BitScanForward(&i, x); return (int)i; }
+#else
+#define SPD_BSWAP16(x) __builtin_bswap16(x)
+#define SPD_BSWAP32(x) __builtin_bswap32(x)
+#define SPD_BSWAP64(x) __builtin_bswap64(x)
+#define SPD_CTZ32(x) __builtin_ctz(x)
+#endif
 using namespace IMSPacketsAPICore;
 
 template class SPDInterfaceBuffer<SPD1>;
@@ -6,224 +30,365 @@ template class SPDInterfaceBuffer<SPD2>;
 template class SPDInterfaceBuffer<SPD4>;
 template class SPDInterfaceBuffer<SPD8>;
 
-// byte by byte binary exchange of data
+// token by token binary exchange of data
 void	Packet::getSPDat(int i, SPD1* SPDPtr)
 {
-	if (i > -1 && i < getNumSPDs())
+	if (i > -1 && i < getNumSPDs() && isInBytesBuffer(i * sizeof(SPD1), sizeof(SPD1)))
 		SPDPtr->uintVal = (bytesBufferPtr + i)[0];
 }
 void	Packet::getSPDat(int i, SPD2* SPDPtr)
 {
-	if (i > -1 && i < getNumSPDs())
-	{
-		for (int j = 0; j < sizeof(SPD2); j++)
-		{
-			SPDPtr->bytes[j] = (bytesBufferPtr + (i * sizeof(SPD2)))[j];
-		}
-	}
+	if (i > -1 && i < getNumSPDs() && isInBytesBuffer(i * sizeof(SPD2), sizeof(SPD2)))
+		memcpy(SPDPtr, bytesBufferPtr + i * sizeof(SPD2), sizeof(SPD2));
 }
 void	Packet::getSPDat(int i, SPD4* SPDPtr)
 {
-	if (i > -1 && i < getNumSPDs())
-	{
-		for (int j = 0; j < sizeof(SPD4); j++)
-		{
-			SPDPtr->bytes[j] = (bytesBufferPtr + (i * sizeof(SPD4)))[j];
-		}
-	}
+	if (i > -1 && i < getNumSPDs() && isInBytesBuffer(i * sizeof(SPD4), sizeof(SPD4)))
+		memcpy(SPDPtr, bytesBufferPtr + i * sizeof(SPD4), sizeof(SPD4));
 }
 void	Packet::getSPDat(int i, SPD8* SPDPtr)
 {
-	if (i > -1 && i < getNumSPDs())
-	{
-		for (int j = 0; j < sizeof(SPD8); j++)
-		{
-			SPDPtr->bytes[j] = (bytesBufferPtr + (i * sizeof(SPD8)))[j];
-		}
-	}
+	if (i > -1 && i < getNumSPDs() && isInBytesBuffer(i * sizeof(SPD8), sizeof(SPD8)))
+		memcpy(SPDPtr, bytesBufferPtr + i * sizeof(SPD8), sizeof(SPD8));
 }
 
-// byte by byte binary exchange of data
+// token by token binary exchange of data
 void	Packet::setSPDat(int i, SPD1* SPDPtr)
 {
-	if (i > -1 && i < getNumSPDs())
+	if (i > -1 && i < getNumSPDs() && isInBytesBuffer(i * sizeof(SPD1), sizeof(SPD1)))
 		(bytesBufferPtr + i)[0] = SPDPtr->uintVal;
 }
 void	Packet::setSPDat(int i, SPD2* SPDPtr)
 {
-	if (i > -1 && i < getNumSPDs())
-	{
-		for (int j = 0; j < sizeof(SPD2); j++)
-		{
-			(bytesBufferPtr + i * sizeof(SPD2))[j] = SPDPtr->bytes[j];
-		}
-	}
+	if (i > -1 && i < getNumSPDs() && isInBytesBuffer(i * sizeof(SPD2), sizeof(SPD2)))
+		memcpy(bytesBufferPtr + i * sizeof(SPD2), SPDPtr, sizeof(SPD2));
 
 }
 void	Packet::setSPDat(int i, SPD4* SPDPtr)
 {
-	if (i > -1 && i < getNumSPDs())
-	{
-		for (int j = 0; j < sizeof(SPD4); j++)
-		{
-			(bytesBufferPtr + i * sizeof(SPD4))[j] = SPDPtr->bytes[j];
-		}
-	}
+	if (i > -1 && i < getNumSPDs() && isInBytesBuffer(i * sizeof(SPD4), sizeof(SPD4)))
+		memcpy(bytesBufferPtr + i * sizeof(SPD4), SPDPtr, sizeof(SPD4));
 
 }
 void	Packet::setSPDat(int i, SPD8* SPDPtr)
 {
-	if (i > -1 && i < getNumSPDs())
-	{
-		for (int j = 0; j < sizeof(SPD8); j++)
-		{
-			(bytesBufferPtr + i * sizeof(SPD8))[j] = SPDPtr->bytes[j];
-		}
-	}
+	if (i > -1 && i < getNumSPDs() && isInBytesBuffer(i * sizeof(SPD8), sizeof(SPD8)))
+		memcpy(bytesBufferPtr + i * sizeof(SPD8), SPDPtr, sizeof(SPD8));
 
 }
 
-// atoi, atof, etc called on char buffer to xfer spd
-bool	Packet::getSPDfromcharsAt(int i, SPD1* SPDPtr, enum SPDValTypeEnum dType)
+// range exchange of data, numSPDs contiguous tokens in one copy
+bool	Packet::getSPDRange(int i, SPD1* SPDPtr, int numSPDs)
+{
+	if (i < 0 || numSPDs < 0 || i + numSPDs > getNumSPDs() || !isInBytesBuffer(i * sizeof(SPD1), numSPDs * sizeof(SPD1)))
+		return false;
+	memcpy(SPDPtr, bytesBufferPtr + i * sizeof(SPD1), numSPDs * sizeof(SPD1));
+	return true;
+}
+bool	Packet::getSPDRange(int i, SPD2* SPDPtr, int numSPDs)
 {
-	if (i > 0 && i < getNumSPDs())
+	if (i < 0 || numSPDs < 0 || i + numSPDs > getNumSPDs() || !isInBytesBuffer(i * sizeof(SPD2), numSPDs * sizeof(SPD2)))
+		return false;
+	memcpy(SPDPtr, bytesBufferPtr + i * sizeof(SPD2), numSPDs * sizeof(SPD2));
+	return true;
+}
+bool	Packet::getSPDRange(int i, SPD4* SPDPtr, int numSPDs)
+{
+	if (i < 0 || numSPDs < 0 || i + numSPDs > getNumSPDs() || !isInBytesBuffer(i * sizeof(SPD4), numSPDs * sizeof(SPD4)))
+		return false;
+	memcpy(SPDPtr, bytesBufferPtr + i * sizeof(SPD4), numSPDs * sizeof(SPD4));
+	return true;
+}
+bool	Packet::getSPDRange(int i, SPD8* SPDPtr, int numSPDs)
+{
+	if (i < 0 || numSPDs < 0 || i + numSPDs > getNumSPDs() || !isInBytesBuffer(i * sizeof(SPD8), numSPDs * sizeof(SPD8)))
+		return false;
+	memcpy(SPDPtr, bytesBufferPtr + i * sizeof(SPD8), numSPDs * sizeof(SPD8));
+	return true;
+}
+
+// range exchange of data, numSPDs contiguous tokens in one copy
+bool	Packet::setSPDRange(int i, SPD1* SPDPtr, int numSPDs)
+{
+	if (i < 0 || numSPDs < 0 || i + numSPDs > getNumSPDs() || !isInBytesBuffer(i * sizeof(SPD1), numSPDs * sizeof(SPD1)))
+		return false;
+	memcpy(bytesBufferPtr + i * sizeof(SPD1), SPDPtr, numSPDs * sizeof(SPD1));
+	return true;
+}
+bool	Packet::setSPDRange(int i, SPD2* SPDPtr, int numSPDs)
+{
+	if (i < 0 || numSPDs < 0 || i + numSPDs > getNumSPDs() || !isInBytesBuffer(i * sizeof(SPD2), numSPDs * sizeof(SPD2)))
+		return false;
+	memcpy(bytesBufferPtr + i * sizeof(SPD2), SPDPtr, numSPDs * sizeof(SPD2));
+	return true;
+}
+bool	Packet::setSPDRange(int i, SPD4* SPDPtr, int numSPDs)
+{
+	if (i < 0 || numSPDs < 0 || i + numSPDs > getNumSPDs() || !isInBytesBuffer(i * sizeof(SPD4), numSPDs * sizeof(SPD4)))
+		return false;
+	memcpy(bytesBufferPtr + i * sizeof(SPD4), SPDPtr, numSPDs * sizeof(SPD4));
+	return true;
+}
+bool	Packet::setSPDRange(int i, SPD8* SPDPtr, int numSPDs)
+{
+	if (i < 0 || numSPDs < 0 || i + numSPDs > getNumSPDs() || !isInBytesBuffer(i * sizeof(SPD8), numSPDs * sizeof(SPD8)))
+		return false;
+	memcpy(bytesBufferPtr + i * sizeof(SPD8), SPDPtr, numSPDs * sizeof(SPD8));
+	return true;
+}
+
+// single pass validate and parse of a token string to xfer spd
+bool	Packet::getSPDfromTokenString(const char* TokenStringPtr, SPD1* SPDPtr, enum SPDValTypeEnum dType)
+{
+	uint64_t uVal;
+	int64_t sVal;
+	switch (dType)
 	{
-		char* TokenStringPtr = (charsBufferPtr + STRINGBUFFER_IDTOKENRATIO + (i - 1) * STRINGBUFFER_TOKENRATIO);
-		switch (dType)
-		{
-		case typeUINT:	if (!isUnsignedIntegerString(TokenStringPtr))	return false; SPDPtr->uintVal = atoi(TokenStringPtr); return true;
-		case typeINT:	if (!isIntegerString(TokenStringPtr))			return false; SPDPtr->uintVal = atoi(TokenStringPtr); return true;
-		}
+	case typeUINT:	if (!TokenStringCodec::ParseUnsigned(TokenStringPtr, STRINGBUFFER_TOKENRATIO, &uVal) || uVal > UINT8_MAX)					return false; SPDPtr->uintVal = (uint8_t)uVal; return true;
+	case typeINT:	if (!TokenStringCodec::ParseSigned(TokenStringPtr, STRINGBUFFER_TOKENRATIO, &sVal) || sVal < INT8_MIN || sVal > INT8_MAX)	return false; SPDPtr->intVal = (int8_t)sVal; return true;
+	default:		break;
 	}
 	return false;
 }
-bool	Packet::getSPDfromcharsAt(int i, SPD2* SPDPtr, enum SPDValTypeEnum dType)
+bool	Packet::getSPDfromTokenString(const char* TokenStringPtr, SPD2* SPDPtr, enum SPDValTypeEnum dType)
 {
-	if (i > 0 && i < getNumSPDs())
+	uint64_t uVal;
+	int64_t sVal;
+	double fVal;
+	switch (dType)
 	{
-		char* TokenStringPtr = (charsBufferPtr + STRINGBUFFER_IDTOKENRATIO + (i - 1) * STRINGBUFFER_TOKENRATIO);
-		switch (dType)
-		{
-		case typeUINT:	if (!isUnsignedIntegerString(TokenStringPtr))	return false; SPDPtr->uintVal = atoi(TokenStringPtr); return true;
-		case typeINT:	if (!isIntegerString(TokenStringPtr))			return false; SPDPtr->uintVal = atoi(TokenStringPtr); return true;
-		case typeFLT:	if (!isNumberString(TokenStringPtr))			return false; SPDPtr->fpVal = atof(TokenStringPtr); return true;
-		}
+	case typeUINT:	if (!TokenStringCodec::ParseUnsigned(TokenStringPtr, STRINGBUFFER_TOKENRATIO, &uVal) || uVal > UINT16_MAX)					return false; SPDPtr->uintVal = (uint16_t)uVal; return true;
+	case typeINT:	if (!TokenStringCodec::ParseSigned(TokenStringPtr, STRINGBUFFER_TOKENRATIO, &sVal) || sVal < INT16_MIN || sVal > INT16_MAX)	return false; SPDPtr->intVal = (int16_t)sVal; return true;
+	case typeFLT:	if (!TokenStringCodec::ParseFloat(TokenStringPtr, STRINGBUFFER_TOKENRATIO, &fVal) || fVal < INT16_MIN || fVal > INT16_MAX)	return false; SPDPtr->fpVal = (short)fVal; return true;
 	}
 	return false;
 }
-bool	Packet::getSPDfromcharsAt(int i, SPD4* SPDPtr, enum SPDValTypeEnum dType)
+bool	Packet::getSPDfromTokenString(const char* TokenStringPtr, SPD4* SPDPtr, enum SPDValTypeEnum dType)
 {
-	if (i > 0 && i < getNumSPDs())
+	uint64_t uVal;
+	int64_t sVal;
+	double fVal;
+	switch (dType)
 	{
-		char* TokenStringPtr = (charsBufferPtr + STRINGBUFFER_IDTOKENRATIO + (i - 1) * STRINGBUFFER_TOKENRATIO);
-		switch (dType)
-		{
-		case typeUINT:	if (!isUnsignedIntegerString(TokenStringPtr))	return false; SPDPtr->uintVal = atol(TokenStringPtr); return true;
-		case typeINT:	if (!isIntegerString(TokenStringPtr))			return false; SPDPtr->uintVal = atol(TokenStringPtr); return true;
-		case typeFLT:	if (!isNumberString(TokenStringPtr))			return false; SPDPtr->fpVal = atof(TokenStringPtr); return true;
-		}
+	case typeUINT:	if (!TokenStringCodec::ParseUnsigned(TokenStringPtr, STRINGBUFFER_TOKENRATIO, &uVal) || uVal > UINT32_MAX)					return false; SPDPtr->uintVal = (uint32_t)uVal; return true;
+	case typeINT:	if (!TokenStringCodec::ParseSigned(TokenStringPtr, STRINGBUFFER_TOKENRATIO, &sVal) || sVal < INT32_MIN || sVal > INT32_MAX)	return false; SPDPtr->intVal = (int32_t)sVal; return true;
+	case typeFLT:	if (!TokenStringCodec::ParseFloat(TokenStringPtr, STRINGBUFFER_TOKENRATIO, &fVal))											return false; SPDPtr->fpVal = (float)fVal; return true;
 	}
 	return false;
 }
-bool	Packet::getSPDfromcharsAt(int i, SPD8* SPDPtr, enum SPDValTypeEnum dType)
+bool	Packet::getSPDfromTokenString(const char* TokenStringPtr, SPD8* SPDPtr, enum SPDValTypeEnum dType)
 {
-	if (i > 0 && i < getNumSPDs())
+	uint64_t uVal;
+	int64_t sVal;
+	double fVal;
+	switch (dType)
 	{
-		char* TokenStringPtr = (charsBufferPtr + STRINGBUFFER_IDTOKENRATIO + (i - 1) * STRINGBUFFER_TOKENRATIO);
-		switch (dType)
-		{
-		case typeUINT:	if (!isUnsignedIntegerString(TokenStringPtr))	return false; SPDPtr->uintVal = atol(TokenStringPtr); return true;
-		case typeINT:	if (!isIntegerString(TokenStringPtr))			return false; SPDPtr->uintVal = atol(TokenStringPtr); return true;
-		case typeFLT:	if (!isNumberString(TokenStringPtr))			return false; SPDPtr->fpVal = atof(TokenStringPtr); return true;
-		}
+	case typeUINT:	if (!TokenStringCodec::ParseUnsigned(TokenStringPtr, STRINGBUFFER_TOKENRATIO, &uVal))	return false; SPDPtr->uintVal = uVal; return true;
+	case typeINT:	if (!TokenStringCodec::ParseSigned(TokenStringPtr, STRINGBUFFER_TOKENRATIO, &sVal))		return false; SPDPtr->intVal = sVal; return true;
+	case typeFLT:	if (!TokenStringCodec::ParseFloat(TokenStringPtr, STRINGBUFFER_TOKENRATIO, &fVal))		return false; SPDPtr->fpVal = fVal; return true;
 	}
 	return false;
 }
 
-// snprintf called on SPDPtr->value according to dType
-bool	Packet::setCharsfromSPDat(int i, SPD1* SPDPtr, enum SPDValTypeEnum dType, const char* fString)
+// SPDPtr->value formatted to a token string according to dType and a parsed format string
+// signed values are written as their token bits by the hex and octal conversions
+bool	Packet::setTokenStringfromSPD(char* TokenStringPtr, SPD1* SPDPtr, enum SPDValTypeEnum dType, struct TokenFormatSpec fSpec)
 {
-	if (i > 0 && i < getNumSPDs())
+	switch (dType)
 	{
-		char* TokenStringPtr = (charsBufferPtr + STRINGBUFFER_IDTOKENRATIO + (i - 1) * STRINGBUFFER_TOKENRATIO);
-		switch (dType)
-		{
-		case typeUINT:	if (snprintf(TokenStringPtr, STRINGBUFFER_TOKENRATIO, fString, SPDPtr->uintVal) < 1)	return false; return true;
-		case typeINT:	if (snprintf(TokenStringPtr, STRINGBUFFER_TOKENRATIO, fString, SPDPtr->intVal) < 1) return false; return true;
-		}
+	case typeUINT:	return (TokenStringCodec::FormatUnsigned(TokenStringPtr, STRINGBUFFER_TOKENRATIO, SPDPtr->uintVal, fSpec) > 0);
+	case typeINT:	if (fSpec.Conversion != fmtConv_Decimal)	return (TokenStringCodec::FormatUnsigned(TokenStringPtr, STRINGBUFFER_TOKENRATIO, SPDPtr->uintVal, fSpec) > 0);
+					return (TokenStringCodec::FormatSigned(TokenStringPtr, STRINGBUFFER_TOKENRATIO, SPDPtr->intVal, fSpec) > 0);
+	default:		break;
 	}
 	return false;
 }
-bool	Packet::setCharsfromSPDat(int i, SPD2* SPDPtr, enum SPDValTypeEnum dType, const char* fString)
+bool	Packet::setTokenStringfromSPD(char* TokenStringPtr, SPD2* SPDPtr, enum SPDValTypeEnum dType, struct TokenFormatSpec fSpec)
 {
-	if (i > 0 && i < getNumSPDs())
+	switch (dType)
 	{
-		char* TokenStringPtr = (charsBufferPtr + STRINGBUFFER_IDTOKENRATIO + (i - 1) * STRINGBUFFER_TOKENRATIO);
-		switch (dType)
-		{
-		case typeUINT:	if (snprintf(TokenStringPtr, STRINGBUFFER_TOKENRATIO, fString, SPDPtr->uintVal) < 1)	return false; return true;
-		case typeINT:	if (snprintf(TokenStringPtr, STRINGBUFFER_TOKENRATIO, fString, SPDPtr->intVal) < 1)		return false; return true;
-		case typeFLT:	if (snprintf(TokenStringPtr, STRINGBUFFER_TOKENRATIO, fString, SPDPtr->fpVal) < 1)		return false; return true;
-		}
+	case typeUINT:	return (TokenStringCodec::FormatUnsigned(TokenStringPtr, STRINGBUFFER_TOKENRATIO, SPDPtr->uintVal, fSpec) > 0);
+	case typeINT:	if (fSpec.Conversion != fmtConv_Decimal)	return (TokenStringCodec::FormatUnsigned(TokenStringPtr, STRINGBUFFER_TOKENRATIO, SPDPtr->uintVal, fSpec) > 0);
+					return (TokenStringCodec::FormatSigned(TokenStringPtr, STRINGBUFFER_TOKENRATIO, SPDPtr->intVal, fSpec) > 0);
+	case typeFLT:	return (TokenStringCodec::FormatFloat(TokenStringPtr, STRINGBUFFER_TOKENRATIO, (float)SPDPtr->fpVal, fSpec) > 0);
 	}
 	return false;
 }
-bool	Packet::setCharsfromSPDat(int i, SPD4* SPDPtr, enum SPDValTypeEnum dType, const char* fString)
+bool	Packet::setTokenStringfromSPD(char* TokenStringPtr, SPD4* SPDPtr, enum SPDValTypeEnum dType, struct TokenFormatSpec fSpec)
 {
-	if (i > 0 && i < getNumSPDs())
+	switch (dType)
 	{
-		char* TokenStringPtr = (charsBufferPtr + STRINGBUFFER_IDTOKENRATIO + (i - 1) * STRINGBUFFER_TOKENRATIO);
-		switch (dType)
-		{
-		case typeUINT:	if (snprintf(TokenStringPtr, STRINGBUFFER_TOKENRATIO, fString, SPDPtr->uintVal) < 1)	return false; return true;
-		case typeINT:
-			if (snprintf(TokenStringPtr, STRINGBUFFER_TOKENRATIO, fString, SPDPtr->intVal) < 1)
-				return false;
-			return true;
-		case typeFLT:	if (snprintf(TokenStringPtr, STRINGBUFFER_TOKENRATIO, fString, SPDPtr->fpVal) < 1)		return false; return true;
-		}
+	case typeUINT:	return (TokenStringCodec::FormatUnsigned(TokenStringPtr, STRINGBUFFER_TOKENRATIO, SPDPtr->uintVal, fSpec) > 0);
+	case typeINT:	if (fSpec.Conversion != fmtConv_Decimal)	return (TokenStringCodec::FormatUnsigned(TokenStringPtr, STRINGBUFFER_TOKENRATIO, SPDPtr->uintVal, fSpec) > 0);
+					return (TokenStringCodec::FormatSigned(TokenStringPtr, STRINGBUFFER_TOKENRATIO, SPDPtr->intVal, fSpec) > 0);
+	case typeFLT:	return (TokenStringCodec::FormatFloat(TokenStringPtr, STRINGBUFFER_TOKENRATIO, SPDPtr->fpVal, fSpec) > 0);
 	}
 	return false;
 }
-bool	Packet::setCharsfromSPDat(int i, SPD8* SPDPtr, enum SPDValTypeEnum dType, const char* fString)
+bool	Packet::setTokenStringfromSPD(char* TokenStringPtr, SPD8* SPDPtr, enum SPDValTypeEnum dType, struct TokenFormatSpec fSpec)
 {
-	if (i > 0 && i < getNumSPDs())
+	switch (dType)
 	{
-		char* TokenStringPtr = (charsBufferPtr + STRINGBUFFER_IDTOKENRATIO + (i - 1) * STRINGBUFFER_TOKENRATIO);
-		switch (dType)
-		{
-		case typeUINT:	if (snprintf(TokenStringPtr, STRINGBUFFER_TOKENRATIO, fString, SPDPtr->uintVal) < 1)	return false; return true;
-		case typeINT:	if (snprintf(TokenStringPtr, STRINGBUFFER_TOKENRATIO, fString, SPDPtr->intVal) < 1)		return false; return true;
-		case typeFLT:	if (snprintf(TokenStringPtr, STRINGBUFFER_TOKENRATIO, fString, SPDPtr->fpVal) < 1)		return false; return true;
-		}
+	case typeUINT:	return (TokenStringCodec::FormatUnsigned(TokenStringPtr, STRINGBUFFER_TOKENRATIO, SPDPtr->uintVal, fSpec) > 0);
+	case typeINT:	if (fSpec.Conversion != fmtConv_Decimal)	return (TokenStringCodec::FormatUnsigned(TokenStringPtr, STRINGBUFFER_TOKENRATIO, SPDPtr->uintVal, fSpec) > 0);
+					return (TokenStringCodec::FormatSigned(TokenStringPtr, STRINGBUFFER_TOKENRATIO, SPDPtr->intVal, fSpec) > 0);
+	case typeFLT:	return (TokenStringCodec::FormatFloat(TokenStringPtr, STRINGBUFFER_TOKENRATIO, SPDPtr->fpVal, fSpec) > 0);
 	}
 	return false;
 }
 
+// single pass validate and parse of char buffer token to xfer spd
+bool	Packet::getSPDfromcharsAt(int i, SPD1* SPDPtr, enum SPDValTypeEnum dType)
+{
+	return (i > 0 && i < getNumSPDs() && isTokenStringInCharsBuffer(i) && getSPDfromTokenString(getTokenStringPtr(i), SPDPtr, dType));
+}
+bool	Packet::getSPDfromcharsAt(int i, SPD2* SPDPtr, enum SPDValTypeEnum dType)
+{
+	return (i > 0 && i < getNumSPDs() && isTokenStringInCharsBuffer(i) && getSPDfromTokenString(getTokenStringPtr(i), SPDPtr, dType));
+}
+bool	Packet::getSPDfromcharsAt(int i, SPD4* SPDPtr, enum SPDValTypeEnum dType)
+{
+	return (i > 0 && i < getNumSPDs() && isTokenStringInCharsBuffer(i) && getSPDfromTokenString(getTokenStringPtr(i), SPDPtr, dType));
+}
+bool	Packet::getSPDfromcharsAt(int i, SPD8* SPDPtr, enum SPDValTypeEnum dType)
+{
+	return (i > 0 && i < getNumSPDs() && isTokenStringInCharsBuffer(i) && getSPDfromTokenString(getTokenStringPtr(i), SPDPtr, dType));
+}
+
+// SPDPtr->value formatted according to dType and a parsed format string
+bool	Packet::setCharsfromSPDat(int i, SPD1* SPDPtr, enum SPDValTypeEnum dType, struct TokenFormatSpec fSpec)
+{
+	return (i > 0 && i < getNumSPDs() && charsSpansPtr == nullptr && isInCharsBuffer(STRINGBUFFER_IDTOKENRATIO + (i - 1) * STRINGBUFFER_TOKENRATIO, STRINGBUFFER_TOKENRATIO)
+		&& setTokenStringfromSPD(charsBufferPtr + STRINGBUFFER_IDTOKENRATIO + (i - 1) * STRINGBUFFER_TOKENRATIO, SPDPtr, dType, fSpec));
+}
+bool	Packet::setCharsfromSPDat(int i, SPD2* SPDPtr, enum SPDValTypeEnum dType, struct TokenFormatSpec fSpec)
+{
+	return (i > 0 && i < getNumSPDs() && charsSpansPtr == nullptr && isInCharsBuffer(STRINGBUFFER_IDTOKENRATIO + (i - 1) * STRINGBUFFER_TOKENRATIO, STRINGBUFFER_TOKENRATIO)
+		&& setTokenStringfromSPD(charsBufferPtr + STRINGBUFFER_IDTOKENRATIO + (i - 1) * STRINGBUFFER_TOKENRATIO, SPDPtr, dType, fSpec));
+}
+bool	Packet::setCharsfromSPDat(int i, SPD4* SPDPtr, enum SPDValTypeEnum dType, struct TokenFormatSpec fSpec)
+{
+	return (i > 0 && i < getNumSPDs() && charsSpansPtr == nullptr && isInCharsBuffer(STRINGBUFFER_IDTOKENRATIO + (i - 1) * STRINGBUFFER_TOKENRATIO, STRINGBUFFER_TOKENRATIO)
+		&& setTokenStringfromSPD(charsBufferPtr + STRINGBUFFER_IDTOKENRATIO + (i - 1) * STRINGBUFFER_TOKENRATIO, SPDPtr, dType, fSpec));
+}
+bool	Packet::setCharsfromSPDat(int i, SPD8* SPDPtr, enum SPDValTypeEnum dType, struct TokenFormatSpec fSpec)
+{
+	return (i > 0 && i < getNumSPDs() && charsSpansPtr == nullptr && isInCharsBuffer(STRINGBUFFER_IDTOKENRATIO + (i - 1) * STRINGBUFFER_TOKENRATIO, STRINGBUFFER_TOKENRATIO)
+		&& setTokenStringfromSPD(charsBufferPtr + STRINGBUFFER_IDTOKENRATIO + (i - 1) * STRINGBUFFER_TOKENRATIO, SPDPtr, dType, fSpec));
+}
+
+// SPDPtr->value formatted according to dType and a format string, parsed at run time
+bool	Packet::setCharsfromSPDat(int i, SPD1* SPDPtr, enum SPDValTypeEnum dType, const char* fString)
+{
+	struct TokenFormatSpec fSpec = TokenStringCodec::ParseFormat(fString);
+	return (TokenStringCodec::isFormatOfType(fSpec, dType) && setCharsfromSPDat(i, SPDPtr, dType, fSpec));
+}
+bool	Packet::setCharsfromSPDat(int i, SPD2* SPDPtr, enum SPDValTypeEnum dType, const char* fString)
+{
+	struct TokenFormatSpec fSpec = TokenStringCodec::ParseFormat(fString);
+	return (TokenStringCodec::isFormatOfType(fSpec, dType) && setCharsfromSPDat(i, SPDPtr, dType, fSpec));
+}
+bool	Packet::setCharsfromSPDat(int i, SPD4* SPDPtr, enum SPDValTypeEnum dType, const char* fString)
+{
+	struct TokenFormatSpec fSpec = TokenStringCodec::ParseFormat(fString);
+	return (TokenStringCodec::isFormatOfType(fSpec, dType) && setCharsfromSPDat(i, SPDPtr, dType, fSpec));
+}
+bool	Packet::setCharsfromSPDat(int i, SPD8* SPDPtr, enum SPDValTypeEnum dType, const char* fString)
+{
+	struct TokenFormatSpec fSpec = TokenStringCodec::ParseFormat(fString);
+	return (TokenStringCodec::isFormatOfType(fSpec, dType) && setCharsfromSPDat(i, SPDPtr, dType, fSpec));
+}
+
 
 // Buffer Accessors
 uint8_t* Packet::getBytesBuffer() { return bytesBufferPtr; }
-void	Packet::setBytesBuffer(uint8_t* bytesBufferPtrIn)
+int		Packet::getBytesBufferSize() { return bytesBufferSize; }
+int		Packet::getBytesTokenSize() { return bytesTokenSize; }
+void	Packet::setBytesBuffer(uint8_t* bytesBufferPtrIn, int bytesBufferSizeIn, int bytesTokenSizeIn)
 {
 	bytesBufferPtr = bytesBufferPtrIn;
+	bytesBufferSize = bytesBufferSizeIn;
+	bytesTokenSize = bytesTokenSizeIn;
 }
 char*	Packet::getCharsBuffer() { return charsBufferPtr; }
-void	Packet::setCharsBuffer(char* charsBufferPtrIn)
+int		Packet::getCharsBufferSize() { return charsBufferSize; }
+void	Packet::setCharsBuffer(char* charsBufferPtrIn, int charsBufferSizeIn)
 {
 	charsBufferPtr = charsBufferPtrIn;
+	charsBufferSize = charsBufferSizeIn;
+	charsSpansPtr = nullptr;
 }
+void	Packet::setCharsSpans(const struct PacketTokenSpan* charsSpansPtrIn) { charsSpansPtr = charsSpansPtrIn; }
+const struct PacketTokenSpan*	Packet::getCharsSpans() { return charsSpansPtr; }
 // Buffer Pointer Copier
 void	Packet::CopyTokenBufferPtrs(Packet* copyPacketPtrs)
 {
 	bytesBufferPtr = copyPacketPtrs->bytesBufferPtr;
 	charsBufferPtr = copyPacketPtrs->charsBufferPtr;
+	bytesBufferSize = copyPacketPtrs->bytesBufferSize;
+	charsBufferSize = copyPacketPtrs->charsBufferSize;
+	bytesTokenSize = copyPacketPtrs->bytesTokenSize;
+	charsSpansPtr = copyPacketPtrs->charsSpansPtr;
 }
 
 
 // Packet ID Comparisons
+// the ID token of the bytes buffer, -1 if the token size is unknown
+int		Packet::ByteBuffer_ID()
+{
+	SPD1 x_SPD1; SPD2 x_SPD2; SPD4 x_SPD4; SPD8 x_SPD8;
+	// IDs are unsigned tokens, so SPD1 IDs of 128 and above stay positive
+	if (bytesBufferPtr == nullptr || !isInBytesBuffer(0, bytesTokenSize))
+		return -1;
+	switch (bytesTokenSize)
+	{
+	case sizeof(SPD1):	memcpy(&x_SPD1, bytesBufferPtr, sizeof(SPD1)); return x_SPD1.uintVal;
+	case sizeof(SPD2):	memcpy(&x_SPD2, bytesBufferPtr, sizeof(SPD2)); return x_SPD2.uintVal;
+	case sizeof(SPD4):	memcpy(&x_SPD4, bytesBufferPtr, sizeof(SPD4)); return (int)x_SPD4.uintVal;
+	case sizeof(SPD8):	memcpy(&x_SPD8, bytesBufferPtr, sizeof(SPD8)); return (int)x_SPD8.uintVal;
+	default:			return -1;
+	}
+}
 bool	Packet::ByteBuffer_ID_Equals(const int compareValue)
 {
-	return (getNumSPDs() == compareValue);
+	return (compareValue > -1 && ByteBuffer_ID() == compareValue);
+}
+bool	Packet::StringBuffer_IDString_Equals(Packet* comparePacketPtr)
+{
+	return (charsBufferPtr != nullptr && IDStringSlot_Equals(charsBufferPtr, comparePacketPtr->getPacketIDString(), comparePacketPtr->getPacketIDStringLength()));
+}
+bool	Packet::IDStringSlot_Equals(const char* idSlotPtr, const char* compareSlotPtr, int idStringLength)
+{
+	int numChars = idStringLength + 1;
+	int i = 0;
+	if (idStringLength < 0 || numChars > STRINGBUFFER_IDTOKENRATIO || idSlotPtr[idStringLength] != 0x00)
+		return false;
+#if defined(__AVX2__)
+	for (; i + 32 <= STRINGBUFFER_IDTOKENRATIO && i < numChars; i += 32)
+	{
+		uint32_t differentMask = ~(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(idSlotPtr + i)), _mm256_loadu_si256((const __m256i*)(compareSlotPtr + i))));
+		if (numChars - i < 32)
+			differentMask &= (1u << (numChars - i)) - 1;
+		if (differentMask != 0)
+			return false;
+	}
+#endif
+#if defined(SPD_SIMD_SSE2)
+	for (; i + 16 <= STRINGBUFFER_IDTOKENRATIO && i < numChars; i += 16)
+	{
+		uint32_t differentMask = ~(uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(idSlotPtr + i)), _mm_loadu_si128((const __m128i*)(compareSlotPtr + i)))) & 0xFFFF;
+		if (numChars - i < 16)
+			differentMask &= (1u << (numChars - i)) - 1;
+		if (differentMask != 0)
+			return false;
+	}
+#endif
+	for (; i < numChars; i++)
+	{
+		if (idSlotPtr[i] != compareSlotPtr[i])
+			return false;
+	}
+	return true;
 }
 bool	Packet::StringBuffer_IDString_Equals(const char* compareStringPtr)
 {
@@ -245,12 +410,8 @@ void	Packet::writebuff_PackID(SPD4* SPDPtr) { SPDPtr->intVal = getPacketID(); se
 void	Packet::writebuff_PackID(SPD8* SPDPtr) { SPDPtr->intVal = getPacketID(); setSPDat(Index_PackID, SPDPtr); }
 void	Packet::writebuff_PackIDString()
 {
-	for (int i = 0; i < STRINGBUFFER_IDTOKENRATIO; i++)
-	{
-		charsBufferPtr[i] = getPacketIDString()[i];
-		if (charsBufferPtr[i] == 0x00)
-			break;
-	}
+	if (isInCharsBuffer(0, STRINGBUFFER_IDTOKENRATIO))
+		memcpy(charsBufferPtr, getPacketIDString(), STRINGBUFFER_IDTOKENRATIO);
 }
 void	Packet::readbuff_PackID(SPD1* SPDPtr) { getSPDat(Index_PackID, SPDPtr); }
 void	Packet::readbuff_PackID(SPD2* SPDPtr) { getSPDat(Index_PackID, SPDPtr); }
@@ -267,8 +428,8 @@ void	Packet::writebuff_PackLength(SPD1* SPDPtr, int numTokens) { SPDPtr->intVal
 void	Packet::writebuff_PackLength(SPD2* SPDPtr, int numTokens) { SPDPtr->intVal = sizeof(SPD2) * numTokens; setSPDat(Index_PackLEN, SPDPtr); }
 void	Packet::writebuff_PackLength(SPD4* SPDPtr, int numTokens) { SPDPtr->intVal = sizeof(SPD4) * numTokens; setSPDat(Index_PackLEN, SPDPtr); }
 void	Packet::writebuff_PackLength(SPD8* SPDPtr, int numTokens) { SPDPtr->intVal = sizeof(SPD8) * numTokens; setSPDat(Index_PackLEN, SPDPtr); }
-void	Packet::writebuff_TokenCountString() { snprintf(charsBufferPtr + STRINGBUFFER_IDTOKENRATIO, STRINGBUFFER_TOKENRATIO, "%d", getNumSPDs()); }
-void	Packet::writebuff_TokenCountString(int numTokens) { snprintf(charsBufferPtr + STRINGBUFFER_IDTOKENRATIO, STRINGBUFFER_TOKENRATIO, "%d", numTokens); }
+void	Packet::writebuff_TokenCountString() { TokenStringCodec::FormatSigned(charsBufferPtr + STRINGBUFFER_IDTOKENRATIO, STRINGBUFFER_TOKENRATIO, getNumSPDs(), TokenStringCodec::ParseFormat("%d")); }
+void	Packet::writebuff_TokenCountString(int numTokens) { TokenStringCodec::FormatSigned(charsBufferPtr + STRINGBUFFER_IDTOKENRATIO, STRINGBUFFER_TOKENRATIO, numTokens, TokenStringCodec::ParseFormat("%d")); }
 void	Packet::readbuff_PackLength(SPD1* SPDPtr) { getSPDat(Index_PackLEN, SPDPtr); }
 void	Packet::readbuff_PackLength(SPD2* SPDPtr) { getSPDat(Index_PackLEN, SPDPtr); }
 void	Packet::readbuff_PackLength(SPD4* SPDPtr) { getSPDat(Index_PackLEN, SPDPtr); }
@@ -288,6 +449,160 @@ bool	Packet::isLetterString(char* inStringPtr) { int index = 0;  while (inString
 bool	Packet::isNumberString(char* inStringPtr) { int index = 0;  while (inStringPtr[index] != 0x00) if (!isNumberchar(inStringPtr[index++])) return false; return true; }
 bool	Packet::isIntegerString(char* inStringPtr) { int index = 0;  while (inStringPtr[index] != 0x00) if (!isIntegerchar(inStringPtr[index++])) return false; return true; }
 bool	Packet::isUnsignedIntegerString(char* inStringPtr) { int index = 0;  while (inStringPtr[index] != 0x00) if (!isUnsignedIntegerchar(inStringPtr[index++])) return false; return true; }
+
+// Bounded String Validators
+static bool	isCharClass(char inChar, enum CharClassEnum charClass)
+{
+	switch (charClass)
+	{
+	case charClass_ASCII:				return Packet::isASCIIchar(inChar);
+	case charClass_Printable:			return (inChar >= ASCII_space && inChar <= ASCII_tilda);
+	case charClass_Letter:				return Packet::isLetterchar(inChar);
+	case charClass_Number:				return Packet::isNumberchar(inChar);
+	case charClass_Integer:				return Packet::isIntegerchar(inChar);
+	case charClass_UnsignedInteger:		return Packet::isUnsignedIntegerchar(inChar);
+	}
+	return false;
+}
+#if defined(__AVX2__)
+static inline __m256i	charsInRange256(__m256i chars, char lowChar, char highChar)
+{
+	return _mm256_and_si256(_mm256_cmpgt_epi8(chars, _mm256_set1_epi8(lowChar - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8(highChar + 1), chars));
+}
+static inline uint32_t	charClassMask256(__m256i chars, enum CharClassEnum charClass)
+{
+	__m256i validChars = charsInRange256(chars, ASCII_0, ASCII_9);
+	switch (charClass)
+	{
+	case charClass_ASCII:
+		validChars = _mm256_or_si256(charsInRange256(chars, ASCII_space, ASCII_tilda), _mm256_cmpeq_epi8(chars, _mm256_set1_epi8(ASCII_lf)));
+		validChars = _mm256_or_si256(validChars, _mm256_cmpeq_epi8(chars, _mm256_set1_epi8(ASCII_cr)));
+		validChars = _mm256_or_si256(validChars, _mm256_cmpeq_epi8(chars, _mm256_set1_epi8(ASCII_tab)));
+		break;
+	case charClass_Printable:	validChars = charsInRange256(chars, ASCII_space, ASCII_tilda); break;
+	case charClass_Letter:		validChars = charsInRange256(_mm256_or_si256(chars, _mm256_set1_epi8(ASCII_a - ASCII_A)), ASCII_a, ASCII_z); break;
+	case charClass_Number:		validChars = _mm256_or_si256(validChars, _mm256_cmpeq_epi8(chars, _mm256_set1_epi8(ASCII_dot)));
+								[[fallthrough]];
+	case charClass_Integer:		validChars = _mm256_or_si256(validChars, _mm256_cmpeq_epi8(chars, _mm256_set1_epi8(ASCII_plus)));
+								validChars = _mm256_or_si256(validChars, _mm256_cmpeq_epi8(chars, _mm256_set1_epi8(ASCII_minus)));
+								[[fallthrough]];
+	case charClass_UnsignedInteger: break;
+	}
+	return (uint32_t)_mm256_movemask_epi8(validChars);
+}
+#endif
+#if defined(SPD_SIMD_SSE2)
+static inline __m128i	charsInRange128(__m128i chars, char lowChar, char highChar)
+{
+	return _mm_and_si128(_mm_cmpgt_epi8(chars, _mm_set1_epi8(lowChar - 1)), _mm_cmplt_epi8(chars, _mm_set1_epi8(highChar + 1)));
+}
+static inline uint32_t	charClassMask128(__m128i chars, enum CharClassEnum charClass)
+{
+	__m128i validChars = charsInRange128(chars, ASCII_0, ASCII_9);
+	switch (charClass)
+	{
+	case charClass_ASCII:
+		validChars = _mm_or_si128(charsInRange128(chars, ASCII_space, ASCII_tilda), _mm_cmpeq_epi8(chars, _mm_set1_epi8(ASCII_lf)));
+		validChars = _mm_or_si128(validChars, _mm_cmpeq_epi8(chars, _mm_set1_epi8(ASCII_cr)));
+		validChars = _mm_or_si128(validChars, _mm_cmpeq_epi8(chars, _mm_set1_epi8(ASCII_tab)));
+		break;
+	case charClass_Printable:	validChars = charsInRange128(chars, ASCII_space, ASCII_tilda); break;
+	case charClass_Letter:		validChars = charsInRange128(_mm_or_si128(chars, _mm_set1_epi8(ASCII_a - ASCII_A)), ASCII_a, ASCII_z); break;
+	case charClass_Number:		validChars = _mm_or_si128(validChars, _mm_cmpeq_epi8(chars, _mm_set1_epi8(ASCII_dot)));
+								[[fallthrough]];
+	case charClass_Integer:		validChars = _mm_or_si128(validChars, _mm_cmpeq_epi8(chars, _mm_set1_epi8(ASCII_plus)));
+								validChars = _mm_or_si128(validChars, _mm_cmpeq_epi8(chars, _mm_set1_epi8(ASCII_minus)));
+								[[fallthrough]];
+	case charClass_UnsignedInteger: break;
+	}
+	return (uint32_t)_mm_movemask_epi8(validChars);
+}
+#endif
+/*	returns the length of the string, up to the first 0x00 or maxLen chars,
+	or -1 if a char before the end of the string is not of the char class
+*/
+int		Packet::scanCharClass(const char* inStringPtr, int maxLen, enum CharClassEnum charClass)
+{
+	int i = 0;
+#if defined(__AVX2__)
+	for (; i + 32 <= maxLen; i += 32)
+	{
+		__m256i chars = _mm256_loadu_si256((const __m256i*)(inStringPtr + i));
+		uint32_t nullMask = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(chars, _mm256_setzero_si256()));
+		uint32_t invalidMask = ~charClassMask256(chars, charClass) & ~nullMask;
+		if (nullMask != 0)
+		{
+			int nullIndex = SPD_CTZ32(nullMask);
+			return ((invalidMask & ((1u << nullIndex) - 1)) != 0) ? -1 : i + nullIndex;
+		}
+		if (invalidMask != 0)
+			return -1;
+	}
+#endif
+#if defined(SPD_SIMD_SSE2)
+	for (; i + 16 <= maxLen; i += 16)
+	{
+		__m128i chars = _mm_loadu_si128((const __m128i*)(inStringPtr + i));
+		uint32_t nullMask = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(chars, _mm_setzero_si128()));
+		uint32_t invalidMask = ~charClassMask128(chars, charClass) & ~nullMask & 0xFFFF;
+		if (nullMask != 0)
+		{
+			int nullIndex = SPD_CTZ32(nullMask);
+			return ((invalidMask & ((1u << nullIndex) - 1)) != 0) ? -1 : i + nullIndex;
+		}
+		if (invalidMask != 0)
+			return -1;
+	}
+#endif
+	for (; i < maxLen; i++)
+	{
+		if (inStringPtr[i] == 0x00)
+			break;
+		if (!isCharClass(inStringPtr[i], charClass))
+			return -1;
+	}
+	return i;
+}
+/*	token chars are printable and neither delimiter nor terminator,
+	any other char ends the token, 16 or 32 chars are classified per compare
+*/
+int		Packet::scanTokenBoundary(const char* inStringPtr, int maxLen)
+{
+	int i = 0;
+#if defined(__AVX2__)
+	for (; i + 32 <= maxLen; i += 32)
+	{
+		__m256i chars = _mm256_loadu_si256((const __m256i*)(inStringPtr + i));
+		__m256i boundaryChars = _mm256_or_si256(_mm256_cmpeq_epi8(chars, _mm256_set1_epi8(ASCII_colon)), _mm256_cmpeq_epi8(chars, _mm256_set1_epi8(ASCII_semicolon)));
+		uint32_t boundaryMask = (uint32_t)_mm256_movemask_epi8(boundaryChars) | ~charClassMask256(chars, charClass_Printable);
+		if (boundaryMask != 0)
+			return i + SPD_CTZ32(boundaryMask);
+	}
+#endif
+#if defined(SPD_SIMD_SSE2)
+	for (; i + 16 <= maxLen; i += 16)
+	{
+		__m128i chars = _mm_loadu_si128((const __m128i*)(inStringPtr + i));
+		__m128i boundaryChars = _mm_or_si128(_mm_cmpeq_epi8(chars, _mm_set1_epi8(ASCII_colon)), _mm_cmpeq_epi8(chars, _mm_set1_epi8(ASCII_semicolon)));
+		uint32_t boundaryMask = ((uint32_t)_mm_movemask_epi8(boundaryChars) | ~charClassMask128(chars, charClass_Printable)) & 0xFFFF;
+		if (boundaryMask != 0)
+			return i + SPD_CTZ32(boundaryMask);
+	}
+#endif
+	for (; i < maxLen; i++)
+	{
+		if (isDelimiterchar(inStringPtr[i]) || isTerminatorchar(inStringPtr[i]) || !isCharClass(inStringPtr[i], charClass_Printable))
+			break;
+	}
+	return i;
+}
+bool	Packet::isASCIIString(const char* inStringPtr, int maxLen) { return (scanCharClass(inStringPtr, maxLen, charClass_ASCII) > -1); }
+bool	Packet::isPrintableString(const char* inStringPtr, int maxLen) { return (scanCharClass(inStringPtr, maxLen, charClass_Printable) > -1); }
+bool	Packet::isLetterString(const char* inStringPtr, int maxLen) { return (scanCharClass(inStringPtr, maxLen, charClass_Letter) > -1); }
+bool	Packet::isNumberString(const char* inStringPtr, int maxLen) { return (scanCharClass(inStringPtr, maxLen, charClass_Number) > -1); }
+bool	Packet::isIntegerString(const char* inStringPtr, int maxLen) { return (scanCharClass(inStringPtr, maxLen, charClass_Integer) > -1); }
+bool	Packet::isUnsignedIntegerString(const char* inStringPtr, int maxLen) { return (scanCharClass(inStringPtr, maxLen, charClass_UnsignedInteger) > -1); }
+
 bool	Packet::stringMatchCaseSensitive(char* inStringPtr, const char* matchString)
 {
 	int i = 0;
@@ -299,3 +614,151 @@ bool	Packet::stringMatchCaseSensitive(char* inStringPtr, const char* matchString
 	}
 	return true;
 }
+
+// Token Byte Order Functions
+bool	Packet::isHostByteOrder(enum SPDByteOrderEnum byteOrder)
+{
+#ifdef ECOSYSTEM_HOST_BIGENDIAN
+	return (byteOrder != byteOrder_LittleEndian);
+#else
+	return (byteOrder != byteOrder_Network);
+#endif
+}
+void	Packet::swapTokenByteOrder(uint8_t* bytesPtr, int numTokens, int tokenSize)
+{
+	int numBytes = numTokens * tokenSize;
+	int i = 0;
+	if (tokenSize != sizeof(SPD2) && tokenSize != sizeof(SPD4) && tokenSize != sizeof(SPD8))
+		return;
+
+	// whole vectors of tokens, one shuffle per vector
+#if defined(__AVX2__)
+	{
+		__m256i shuffleMask;
+		switch (tokenSize)
+		{
+		case sizeof(SPD2): shuffleMask = _mm256_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14, 1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14); break;
+		case sizeof(SPD4): shuffleMask = _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12, 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12); break;
+		default: shuffleMask = _mm256_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8); break;
+		}
+		for (; i + 32 <= numBytes; i += 32)
+		{
+			__m256i tokens = _mm256_loadu_si256((const __m256i*)(bytesPtr + i));
+			_mm256_storeu_si256((__m256i*)(bytesPtr + i), _mm256_shuffle_epi8(tokens, shuffleMask));
+		}
+	}
+#endif
+#if defined(__SSSE3__) || defined(__AVX2__)
+	{
+		__m128i shuffleMask;
+		switch (tokenSize)
+		{
+		case sizeof(SPD2): shuffleMask = _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14); break;
+		case sizeof(SPD4): shuffleMask = _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12); break;
+		default: shuffleMask = _mm_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8); break;
+		}
+		for (; i + 16 <= numBytes; i += 16)
+		{
+			__m128i tokens = _mm_loadu_si128((const __m128i*)(bytesPtr + i));
+			_mm_storeu_si128((__m128i*)(bytesPtr + i), _mm_shuffle_epi8(tokens, shuffleMask));
+		}
+	}
+#endif
+
+	// remaining tokens, one bswap per token
+	switch (tokenSize)
+	{
+	case sizeof(SPD2):
+		for (; i < numBytes; i += sizeof(SPD2))
+		{
+			uint16_t tokenVal;
+			memcpy(&tokenVal, bytesPtr + i, sizeof(SPD2));
+			tokenVal = SPD_BSWAP16(tokenVal);
+			memcpy(bytesPtr + i, &tokenVal, sizeof(SPD2));
+		}
+		break;
+	case sizeof(SPD4):
+		for (; i < numBytes; i += sizeof(SPD4))
+		{
+			uint32_t tokenVal;
+			memcpy(&tokenVal, bytesPtr + i, sizeof(SPD4));
+			tokenVal = SPD_BSWAP32(tokenVal);
+			memcpy(bytesPtr + i, &tokenVal, sizeof(SPD4));
+		}
+		break;
+	case sizeof(SPD8):
+		for (; i < numBytes; i += sizeof(SPD8))
+		{
+			uint64_t tokenVal;
+			memcpy(&tokenVal, bytesPtr + i, sizeof(SPD8));
+			tokenVal = SPD_BSWAP64(tokenVal);
+			memcpy(bytesPtr + i, &tokenVal, sizeof(SPD8));
+		}
+		break;
+	}
+}
+
+#ifndef SPD_SIMD_CRC32C
+// CRC-32C, reflected polynomial 0x82F63B78
+struct CRC32CTables
+{
+	uint32_t Table[8][256];
+	constexpr CRC32CTables() : Table()
+	{
+		for (uint32_t i = 0; i < 256; i++)
+		{
+			uint32_t crcVal = i;
+			for (int j = 0; j < 8; j++)
+				crcVal = (crcVal >> 1) ^ ((crcVal & 1u) ? 0x82F63B78u : 0u);
+			Table[0][i] = crcVal;
+		}
+		for (int k = 1; k < 8; k++)
+			for (int i = 0; i < 256; i++)
+				Table[k][i] = (Table[k - 1][i] >> 8) ^ Table[0][Table[k - 1][i] & 0xFF];
+	}
+};
+static constexpr struct CRC32CTables crc32cTables;
+#endif
+
+uint32_t	Packet::CRC32C(const uint8_t* bytesPtr, int numBytes, uint32_t crcIn)
+{
+	uint32_t crcVal = ~crcIn;
+	int i = 0;
+#if defined(SPD_SIMD_CRC32C)
+	// one crc32 instruction per 8 (or 4) bytes
+#if defined(__x86_64__) || defined(_M_X64)
+	{
+		uint64_t crcVal64 = crcVal;
+		for (; i + 8 <= numBytes; i += 8)
+		{
+			uint64_t wordVal;
+			memcpy(&wordVal, bytesPtr + i, sizeof(wordVal));
+			crcVal64 = _mm_crc32_u64(crcVal64, wordVal);
+		}
+		crcVal = (uint32_t)crcVal64;
+	}
+#endif
+	for (; i + 4 <= numBytes; i += 4)
+	{
+		uint32_t wordVal;
+		memcpy(&wordVal, bytesPtr + i, sizeof(wordVal));
+		crcVal = _mm_crc32_u32(crcVal, wordVal);
+	}
+	for (; i < numBytes; i++)
+		crcVal = _mm_crc32_u8(crcVal, bytesPtr[i]);
+#else
+	// 8 bytes per step, composed byte by byte so any host byte order reads the same
+	for (; i + 8 <= numBytes; i += 8)
+	{
+		uint32_t loVal = crcVal ^ ((uint32_t)bytesPtr[i] | ((uint32_t)bytesPtr[i + 1] << 8) | ((uint32_t)bytesPtr[i + 2] << 16) | ((uint32_t)bytesPtr[i + 3] << 24));
+		uint32_t hiVal = (uint32_t)bytesPtr[i + 4] | ((uint32_t)bytesPtr[i + 5] << 8) | ((uint32_t)bytesPtr[i + 6] << 16) | ((uint32_t)bytesPtr[i + 7] << 24);
+		crcVal = crc32cTables.Table[7][loVal & 0xFF] ^ crc32cTables.Table[6][(loVal >> 8) & 0xFF]
+			^ crc32cTables.Table[5][(loVal >> 16) & 0xFF] ^ crc32cTables.Table[4][loVal >> 24]
+			^ crc32cTables.Table[3][hiVal & 0xFF] ^ crc32cTables.Table[2][(hiVal >> 8) & 0xFF]
+			^ crc32cTables.Table[1][(hiVal >> 16) & 0xFF] ^ crc32cTables.Table[0][hiVal >> 24];
+	}
+	for (; i < numBytes; i++)
+		crcVal = crc32cTables.Table[0][(crcVal ^ bytesPtr[i]) & 0xFF] ^ (crcVal >> 8);
+#endif
+	return ~crcVal;
+}
@@ -6,6 +6,7 @@
 #ifndef __LANGUAGECONSTRUCTS__
 #define __LANGUAGECONSTRUCTS__
 #include "0_EcoSystemRestrictions.h"
+#include "1_TokenStringCodec.h"
 
 /*! \defgroup LanguageConstructs
 	\brief Fundamental Elements of Packet Communications
@@ -62,6 +63,10 @@
 	- TEMPLATE_SPDSET(tokenName, SPDvar,SPDindex)
 	- TEMPLATE_SPDGET(tokenName, SPDvar, SPDindex)
 
+	Template macros are provided to declare the compile-time schema of a packet, one field at a time.
+	- TEMPLATE_SPDFIELD_H(tokenName, SPDindex, dTypeEnum)
+	- TEMPLATE_SPDARRAYFIELD_H(tokenName, SPDindex, SPDcount, dTypeEnum)
+
 	Template macros are provided to simplify implementation and reduce error when defining overridden api endpoint functions.
 	- TEMPLATE_RX_HANDLER(tempHDRPack,Packet_Type, TokenID, HandlerFunc)
 	- TEMPLATE_TX_PACKAGER(tVar, pType, SPDindex, packFunc)
@@ -104,20 +109,34 @@
 
 
 
+/*! \def TEMPLATE_STATICPACKETINFO_H(packID, numTokens)
+	\brief Code Template for the static ID and size information of a Packet class
+
+	IDString is stored in a full ID token slot of STRINGBUFFER_IDTOKENRATIO chars, padded
+	with 0x00, so it is copied and compared a slot at a time.  Its length and hash are
+	computed at compile time.
+*/
 #define TEMPLATE_STATICPACKETINFO_H(packID, numTokens)\
 static const int ID = packID;\
-static const char IDString[];\
+alignas(32) static const char IDString[STRINGBUFFER_IDTOKENRATIO];\
+static constexpr int IDStringLength = sizeof(#packID) - 1;\
+static_assert(IDStringLength < STRINGBUFFER_IDTOKENRATIO, "ID string and its terminator must fit the ID token");\
+static constexpr uint32_t IDStringHashCode = Packet::IDStringHash(#packID);\
 static const int TokenCount = numTokens;\
 int getNumSPDs();\
 int getPacketID();\
 char* getPacketIDString();\
+int getPacketIDStringLength();\
+uint32_t getPacketIDStringHash();\
 
 
 #define TEMPLATE_STATICPACKETINFO_CPP(packID)\
-const char Packet_##packID::IDString[] = #packID;\
+alignas(32) const char Packet_##packID::IDString[STRINGBUFFER_IDTOKENRATIO] = #packID;\
 int Packet_##packID::getNumSPDs(){return TokenCount;}\
 int Packet_##packID::getPacketID(){return ID;}\
 char* Packet_##packID::getPacketIDString(){return (char*)&IDString[0];}\
+int Packet_##packID::getPacketIDStringLength(){return IDStringLength;}\
+uint32_t Packet_##packID::getPacketIDStringHash(){return IDStringHashCode;}\
 
 
 #define pCLASS(packIDmacro) Packet_##packIDmacro
@@ -160,6 +179,8 @@ void PacketType::set##tokenName(SPD8* my##tokenName){setSPDat(SPDindex,my##token
 	-SPD4
 	-SPD8
 
+	The format string is parsed, and checked against the data type, at compile time.
+
 */
 #define TEMPLATE_SPDSETSTRING_H(tokenName)\
 bool set2String##tokenName(SPD1* my##tokenName);\
@@ -168,11 +189,16 @@ bool set2String##tokenName(SPD4* my##tokenName);\
 bool set2String##tokenName(SPD8* my##tokenName);\
 
 
+#define TEMPLATE_SPDSETSTRING_BODY(tokenName, SPDindex, dTypeEnum, formatString)\
+{constexpr struct TokenFormatSpec fSpec = TokenStringCodec::ParseFormat(formatString);\
+static_assert(TokenStringCodec::isFormatOfType(fSpec, dTypeEnum), "format string of " #tokenName " is invalid for its data type");\
+return setCharsfromSPDat(SPDindex,my##tokenName,dTypeEnum,fSpec);}\
+
 #define TEMPLATE_SPDSETSTRING_CPP(PacketType, tokenName, SPDindex, dTypeEnum, formatString)\
-bool PacketType::set2String##tokenName(SPD1* my##tokenName){return setCharsfromSPDat(SPDindex,my##tokenName,dTypeEnum,formatString);}\
-bool PacketType::set2String##tokenName(SPD2* my##tokenName){return setCharsfromSPDat(SPDindex,my##tokenName,dTypeEnum,formatString);}\
-bool PacketType::set2String##tokenName(SPD4* my##tokenName){return setCharsfromSPDat(SPDindex,my##tokenName,dTypeEnum,formatString);}\
-bool PacketType::set2String##tokenName(SPD8* my##tokenName){return setCharsfromSPDat(SPDindex,my##tokenName,dTypeEnum,formatString);}\
+bool PacketType::set2String##tokenName(SPD1* my##tokenName)TEMPLATE_SPDSETSTRING_BODY(tokenName, SPDindex, dTypeEnum, formatString)\
+bool PacketType::set2String##tokenName(SPD2* my##tokenName)TEMPLATE_SPDSETSTRING_BODY(tokenName, SPDindex, dTypeEnum, formatString)\
+bool PacketType::set2String##tokenName(SPD4* my##tokenName)TEMPLATE_SPDSETSTRING_BODY(tokenName, SPDindex, dTypeEnum, formatString)\
+bool PacketType::set2String##tokenName(SPD8* my##tokenName)TEMPLATE_SPDSETSTRING_BODY(tokenName, SPDindex, dTypeEnum, formatString)\
 
 /*! \def TEMPLATE_SPDGET(tokenName, SPDindex)
 	\brief Code Template for Packet Accessor (GET) Functions
@@ -225,17 +251,65 @@ TEMPLATE_SPDSETSTRING_CPP(PacketType, tokenName, SPDindex, dTypeEnum, formatStri
 TEMPLATE_SPDGETSTRING_CPP(PacketType, tokenName, SPDindex, dTypeEnum)\
 
 
+/*! \def TEMPLATE_SPDFIELD_H(tokenName, SPDindex, dTypeEnum)
+	\brief Code Template for Compile-Time Packet Schema Fields
+
+	This template declares, inside a packet class, the field descriptor type
+	Field_tokenName and a pair of inlined accessor templates
+	-readbuff_tokenName(TokenType*)
+	-writebuff_tokenName(TokenType*)
+
+	The token index and token type are known at compile time, so the accessors
+	are non-virtual, bounds checked against the packet TokenCount by the compiler,
+	and reduce to a single load or store of the token.  They return false, and
+	move nothing, if the token lies past the end of a bytes buffer of known size.
+	It must follow TEMPLATE_STATICPACKETINFO_H in the packet class declaration.
+
+*/
+#define TEMPLATE_SPDFIELD_H(tokenName, SPDindex, dTypeEnum)\
+typedef SPDField<SPDindex, TokenCount, dTypeEnum> Field_##tokenName;\
+template<class TokenType> inline bool readbuff_##tokenName(TokenType* my##tokenName){return readbuff_Field<Field_##tokenName>(my##tokenName);}\
+template<class TokenType> inline bool writebuff_##tokenName(TokenType* my##tokenName){return writebuff_Field<Field_##tokenName>(my##tokenName);}\
+
+
+/*! \def TEMPLATE_SPDARRAYFIELD_H(tokenName, SPDindex, SPDcount, dTypeEnum)
+	\brief Code Template for Compile-Time Packet Schema Array Fields
+
+	Same as TEMPLATE_SPDFIELD_H for a run of SPDcount contiguous tokens of the same type
+	starting at SPDindex.  The accessors take an array of SPDcount tokens and move the
+	whole run with a single copy.
+
+*/
+#define TEMPLATE_SPDARRAYFIELD_H(tokenName, SPDindex, SPDcount, dTypeEnum)\
+typedef SPDField<SPDindex, TokenCount, dTypeEnum, SPDcount> Field_##tokenName;\
+template<class TokenType> inline bool readbuff_##tokenName(TokenType (&my##tokenName)[SPDcount]){return readbuff_Field<Field_##tokenName>(&my##tokenName[0]);}\
+template<class TokenType> inline bool writebuff_##tokenName(TokenType (&my##tokenName)[SPDcount]){return writebuff_Field<Field_##tokenName>(&my##tokenName[0]);}\
+
+
 /*! @} */
 
 namespace IMSPacketsAPICore
 {
-	/*! \brief SPD data type encoding
+	/*! \brief Byte order of multi-byte tokens
+
+		byteOrder_Network is most significant byte first (big-endian).
+	*/
+	enum SPDByteOrderEnum
+	{
+		byteOrder_Native,
+		byteOrder_LittleEndian,
+		byteOrder_Network
+	};
+	/*! \brief Character classes of the bounded string validators
 	*/
-	enum SPDValTypeEnum
+	enum CharClassEnum
 	{
-		typeUINT,
-		typeINT,
-		typeFLT
+		charClass_ASCII,
+		charClass_Printable,
+		charClass_Letter,
+		charClass_Number,
+		charClass_Integer,
+		charClass_UnsignedInteger
 	};
 	/*! \union SPD1
 		\brief Data abstraction element
@@ -289,33 +363,101 @@ namespace IMSPacketsAPICore
 	};
 
 
+	/*! \struct SPDTokenTraits
+		\brief compile-time identification of token types
+		\ingroup LanguageConstructs
+
+		Only the SPD unions are valid token types of packet buffers.
+	*/
+	template<class TokenType>
+	struct SPDTokenTraits
+	{
+		static const bool isSPD = false;
+	};
+	template<> struct SPDTokenTraits<SPD1> { static const bool isSPD = true; };
+	template<> struct SPDTokenTraits<SPD2> { static const bool isSPD = true; };
+	template<> struct SPDTokenTraits<SPD4> { static const bool isSPD = true; };
+	template<> struct SPDTokenTraits<SPD8> { static const bool isSPD = true; };
+
+
+	/*! \struct SPDField
+		\brief Compile-time description of a packet token
+		\ingroup LanguageConstructs
+
+		A packet schema is the set of SPDField descriptors declared in a packet class
+		with TEMPLATE_SPDFIELD_H, together with its static ID and TokenCount.  The token
+		index is validated against the packet token count when the descriptor is declared.
+		Array fields span SPDcount contiguous tokens.  As with the runtime accessors, the
+		packet is expected to be bound to a buffer of at least its TokenCount tokens.
+	*/
+	template<int SPDindex, int numTokens, enum SPDValTypeEnum dType = typeINT, int SPDcount = 1>
+	struct SPDField
+	{
+		static_assert(SPDindex > -1 && SPDcount > 0 && SPDindex + SPDcount <= numTokens, "SPDField tokens are outside of the packet token count");
+
+		static const int					Index = SPDindex;
+		static const int					Count = SPDcount;
+		static const int					PacketTokenCount = numTokens;
+		static const enum SPDValTypeEnum	ValType = dType;
+
+		template<class TokenType>
+		static constexpr int ByteOffset() { return SPDindex * (int)sizeof(TokenType); }
+	};
+
+
 	/*! \class SPDInterfaceBuffer
 		\brief template class for binary token buffers
 		\ingroup LanguageConstructs
 
-		Here data space is allocated for token buffers
+		Here data space is allocated for token buffers of TokenCapacity tokens
 	*/
-	template<class TokenType>
+	template<class TokenType, int TokenCapacity = PACKETBUFFER_TOKENCOUNT>
 	class SPDInterfaceBuffer
 	{
+		static_assert(TokenCapacity >= 4, "token buffers hold at least the 4 header tokens");
 	public:
+		static const int		Capacity = TokenCapacity;
 		union {
-			TokenType			SPDs[PACKETBUFFER_TOKENCOUNT];
-			uint8_t				bytes[sizeof(TokenType) * PACKETBUFFER_TOKENCOUNT];
+			TokenType			SPDs[TokenCapacity];
+			uint8_t				bytes[sizeof(TokenType) * TokenCapacity];
 		};
 	};
 	
 	
-	/*! \class SPDASCIIInterfaceBuffer
-		\brief class for string token buffers
+	/*! \class SPDASCIIInterfaceBufferSized
+		\brief template class for string token buffers
 		\ingroup LanguageConstructs
 
-		Here data space is allocated for token buffers
+		Here data space is allocated for string token buffers of TokenCapacity tokens
 	*/
-	class SPDASCIIInterfaceBuffer
+	template<int TokenCapacity = PACKETBUFFER_TOKENCOUNT>
+	class SPDASCIIInterfaceBufferSized
 	{
+		static_assert(TokenCapacity >= 4, "token buffers hold at least the 4 header tokens");
 	public:
-		char					chars[STRINGBUFFER_CHARCOUNT];
+		static const int		Capacity = TokenCapacity;
+		char					chars[STRINGBUFFER_CHARCOUNT_OF(TokenCapacity)];
+	};
+
+	/*! \class SPDASCIIInterfaceBuffer
+		\brief class for string token buffers of the default capacity
+		\ingroup LanguageConstructs
+	*/
+	typedef SPDASCIIInterfaceBufferSized<PACKETBUFFER_TOKENCOUNT> SPDASCIIInterfaceBuffer;
+
+	/*! \struct PacketTokenSpan
+		\brief Location of a token string in a compact (wire order) char buffer
+		\ingroup LanguageConstructs
+
+		A compact buffer holds the received chars as they were framed, each delimiter replaced by
+		a terminator, instead of tokens padded to fixed slots.  A table of spans, one per token of
+		the buffer capacity, locates each token.  Spans past the last token of a packet have a
+		Length of 0.
+	*/
+	struct PacketTokenSpan
+	{
+		uint16_t	Offset;
+		uint16_t	Length;
 	};
 	
 	
@@ -332,27 +474,87 @@ namespace IMSPacketsAPICore
 	private:
 		uint8_t*	bytesBufferPtr = nullptr;
 		char*		charsBufferPtr = nullptr;
+		int			bytesBufferSize = -1;	// -1 when unknown, bounded by token count only
+		int			charsBufferSize = -1;	// -1 when unknown, bounded by token count only
+		int			bytesTokenSize = 0;		// 0 when unknown, the size of SPDs in the bytes buffer
+		const struct PacketTokenSpan*	charsSpansPtr = nullptr;	// nullptr when token strings are in fixed slots
+
+		inline bool	isInBytesBuffer(int byteOffset, int numBytes) { return (bytesBufferSize < 0 || byteOffset + numBytes <= bytesBufferSize); }
+		inline bool	isInCharsBuffer(int charOffset, int numChars) { return (charsBufferSize < 0 || charOffset + numChars <= charsBufferSize); }
+		// token string i and its terminator, in its slot or at its span
+		inline bool	isTokenStringInCharsBuffer(int i)
+		{
+			if (charsSpansPtr != nullptr)
+				return (charsSpansPtr[i].Length > 0 && isInCharsBuffer(charsSpansPtr[i].Offset, charsSpansPtr[i].Length + 1));
+			return isInCharsBuffer(STRINGBUFFER_IDTOKENRATIO + (i - 1) * STRINGBUFFER_TOKENRATIO, STRINGBUFFER_TOKENRATIO);
+		}
+		inline char*	getTokenStringPtr(int i) { return charsBufferPtr + ((charsSpansPtr != nullptr) ? charsSpansPtr[i].Offset : STRINGBUFFER_IDTOKENRATIO + (i - 1) * STRINGBUFFER_TOKENRATIO); }
 	protected:
-		// byte by byte binary exchange of data
+		// token by token binary exchange of data
 		void		getSPDat(int i, SPD1* SPDPtr);
 		void		getSPDat(int i, SPD2* SPDPtr);
 		void		getSPDat(int i, SPD4* SPDPtr);
 		void		getSPDat(int i, SPD8* SPDPtr);
 
-		// byte by byte binary exchange of data
+		// token by token binary exchange of data
 		void		setSPDat(int i, SPD1* SPDPtr);
 		void		setSPDat(int i, SPD2* SPDPtr);
 		void		setSPDat(int i, SPD4* SPDPtr);
 		void		setSPDat(int i, SPD8* SPDPtr);
 
-
-		// atoi, atof, etc called on char buffer to xfer spd
+		// range exchange of data, numSPDs contiguous tokens in one copy
+		bool		getSPDRange(int i, SPD1* SPDPtr, int numSPDs);
+		bool		getSPDRange(int i, SPD2* SPDPtr, int numSPDs);
+		bool		getSPDRange(int i, SPD4* SPDPtr, int numSPDs);
+		bool		getSPDRange(int i, SPD8* SPDPtr, int numSPDs);
+
+		// range exchange of data, numSPDs contiguous tokens in one copy
+		bool		setSPDRange(int i, SPD1* SPDPtr, int numSPDs);
+		bool		setSPDRange(int i, SPD2* SPDPtr, int numSPDs);
+		bool		setSPDRange(int i, SPD4* SPDPtr, int numSPDs);
+		bool		setSPDRange(int i, SPD8* SPDPtr, int numSPDs);
+
+#ifdef ECOSYSTEM_HAS_SPAN
+		template<class TokenType>
+		inline bool	getSPDRange(int i, std::span<TokenType> SPDSpan) { return getSPDRange(i, SPDSpan.data(), (int)SPDSpan.size()); }
+		template<class TokenType>
+		inline bool	setSPDRange(int i, std::span<TokenType> SPDSpan) { return setSPDRange(i, SPDSpan.data(), (int)SPDSpan.size()); }
+#endif
+
+		// compile-time indexed exchange of data, a single load or store (or copy for array fields)
+		// false if the field lies past the end of a bytes buffer of known size, e.g. a short received frame
+		template<class Field, class TokenType>
+		inline bool	readbuff_Field(TokenType* SPDPtr)
+		{
+			static_assert(SPDTokenTraits<TokenType>::isSPD, "token type must be SPD1, SPD2, SPD4, or SPD8");
+			if (!isInBytesBuffer(Field::template ByteOffset<TokenType>(), Field::Count * sizeof(TokenType)))
+				return false;
+			memcpy(SPDPtr, bytesBufferPtr + Field::template ByteOffset<TokenType>(), Field::Count * sizeof(TokenType));
+			return true;
+		}
+		template<class Field, class TokenType>
+		inline bool	writebuff_Field(TokenType* SPDPtr)
+		{
+			static_assert(SPDTokenTraits<TokenType>::isSPD, "token type must be SPD1, SPD2, SPD4, or SPD8");
+			if (!isInBytesBuffer(Field::template ByteOffset<TokenType>(), Field::Count * sizeof(TokenType)))
+				return false;
+			memcpy(bytesBufferPtr + Field::template ByteOffset<TokenType>(), SPDPtr, Field::Count * sizeof(TokenType));
+			return true;
+		}
+
+		// single pass validate and parse of char buffer token to xfer spd
 		bool		getSPDfromcharsAt(int i, SPD1* SPDPtr, enum SPDValTypeEnum dType);
 		bool		getSPDfromcharsAt(int i, SPD2* SPDPtr, enum SPDValTypeEnum dType);
 		bool		getSPDfromcharsAt(int i, SPD4* SPDPtr, enum SPDValTypeEnum dType);
 		bool		getSPDfromcharsAt(int i, SPD8* SPDPtr, enum SPDValTypeEnum dType);
 		
-		// snprintf called on SPDPtr->value according to dType
+		// SPDPtr->value formatted according to dType and a parsed format string
+		bool		setCharsfromSPDat(int i, SPD1* SPDPtr, enum SPDValTypeEnum dType, struct TokenFormatSpec fSpec);
+		bool		setCharsfromSPDat(int i, SPD2* SPDPtr, enum SPDValTypeEnum dType, struct TokenFormatSpec fSpec);
+		bool		setCharsfromSPDat(int i, SPD4* SPDPtr, enum SPDValTypeEnum dType, struct TokenFormatSpec fSpec);
+		bool		setCharsfromSPDat(int i, SPD8* SPDPtr, enum SPDValTypeEnum dType, struct TokenFormatSpec fSpec);
+
+		// SPDPtr->value formatted according to dType and a format string, parsed at run time
 		bool		setCharsfromSPDat(int i, SPD1* SPDPtr, enum SPDValTypeEnum dType, const char* fString);
 		bool		setCharsfromSPDat(int i, SPD2* SPDPtr, enum SPDValTypeEnum dType, const char* fString);
 		bool		setCharsfromSPDat(int i, SPD4* SPDPtr, enum SPDValTypeEnum dType, const char* fString);
@@ -363,17 +565,69 @@ namespace IMSPacketsAPICore
 
 	public:
 		uint8_t*	getBytesBuffer();
-		void		setBytesBuffer(uint8_t* bytesBufferPtrIn);
+		int			getBytesBufferSize();
+		int			getBytesTokenSize();
+		void		setBytesBuffer(uint8_t* bytesBufferPtrIn, int bytesBufferSizeIn = -1, int bytesTokenSizeIn = 0);
 		char*		getCharsBuffer();
-		void		setCharsBuffer(char* charsBufferPtrIn);
+		int			getCharsBufferSize();
+		void		setCharsBuffer(char* charsBufferPtrIn, int charsBufferSizeIn = -1);
+		/*! \fn setCharsSpans
+			\brief Locate the token strings of a compact chars buffer by a table of spans
+			\sa PacketTokenSpan
+
+			Set after setCharsBuffer, which restores fixed slots.  Token strings of a compact buffer
+			are read only, setting them fails.
+		*/
+		void		setCharsSpans(const struct PacketTokenSpan* charsSpansPtrIn);
+		const struct PacketTokenSpan*	getCharsSpans();
 		void		CopyTokenBufferPtrs(Packet* copyPacketPtrs);
 				
 		virtual int				getPacketID() = 0;
 		virtual char*			getPacketIDString() = 0;
+		virtual int				getPacketIDStringLength() = 0;
+		virtual uint32_t		getPacketIDStringHash() = 0;
 		virtual int				getNumSPDs() = 0;
 
+		int						ByteBuffer_ID();
 		bool					ByteBuffer_ID_Equals(const int compareValue);
 		bool					StringBuffer_IDString_Equals(const char* compareStringPtr);
+		bool					StringBuffer_IDString_Equals(Packet* comparePacketPtr);
+		template<class PacketClass>
+		inline bool				StringBuffer_IDString_Equals() { return (charsBufferPtr != nullptr && IDStringSlot_Equals(charsBufferPtr, PacketClass::IDString, PacketClass::IDStringLength)); }
+
+		/*! \fn IDStringSlot_Equals
+			\brief Compare an ID string of known length, and its terminator, in two ID token slots
+
+			Both pointers address a slot of STRINGBUFFER_IDTOKENRATIO chars, chars after the
+			terminator are ignored.  The slots are compared with one or two vector compares.
+		*/
+		static bool				IDStringSlot_Equals(const char* idSlotPtr, const char* compareSlotPtr, int idStringLength);
+
+		// single pass validate and parse of a token string of STRINGBUFFER_TOKENRATIO chars
+		static bool				getSPDfromTokenString(const char* TokenStringPtr, SPD1* SPDPtr, enum SPDValTypeEnum dType);
+		static bool				getSPDfromTokenString(const char* TokenStringPtr, SPD2* SPDPtr, enum SPDValTypeEnum dType);
+		static bool				getSPDfromTokenString(const char* TokenStringPtr, SPD4* SPDPtr, enum SPDValTypeEnum dType);
+		static bool				getSPDfromTokenString(const char* TokenStringPtr, SPD8* SPDPtr, enum SPDValTypeEnum dType);
+
+		// SPDPtr->value formatted to a token string of STRINGBUFFER_TOKENRATIO chars
+		static bool				setTokenStringfromSPD(char* TokenStringPtr, SPD1* SPDPtr, enum SPDValTypeEnum dType, struct TokenFormatSpec fSpec);
+		static bool				setTokenStringfromSPD(char* TokenStringPtr, SPD2* SPDPtr, enum SPDValTypeEnum dType, struct TokenFormatSpec fSpec);
+		static bool				setTokenStringfromSPD(char* TokenStringPtr, SPD4* SPDPtr, enum SPDValTypeEnum dType, struct TokenFormatSpec fSpec);
+		static bool				setTokenStringfromSPD(char* TokenStringPtr, SPD8* SPDPtr, enum SPDValTypeEnum dType, struct TokenFormatSpec fSpec);
+
+		/*! \fn IDStringHash
+			\brief FNV-1a hash of an ID string of at most STRINGBUFFER_IDTOKENRATIO chars
+
+			Evaluated at compile time for the ID strings of a language, and at run time
+			for the ID string token of a received packet.
+		*/
+		static constexpr uint32_t IDStringHash(const char* idStringPtr)
+		{
+			uint32_t hashVal = 2166136261u;
+			for (int i = 0; i < STRINGBUFFER_IDTOKENRATIO && idStringPtr[i] != 0x00; i++)
+				hashVal = (hashVal ^ (uint8_t)idStringPtr[i]) * 16777619u;
+			return hashVal;
+		}
 
 		// PackID Accessors
 		void					writebuff_PackID(SPD1* SPDPtr);
@@ -420,6 +674,29 @@ namespace IMSPacketsAPICore
 		static bool				isUnsignedIntegerString(char* inStringPtr);
 		static bool				stringMatchCaseSensitive(char* inStringPtr, const char* matchString);
 
+		// Bounded String Validators, at most maxLen chars are read
+		static int				scanCharClass(const char* inStringPtr, int maxLen, enum CharClassEnum charClass);
+		static bool				isASCIIString(const char* inStringPtr, int maxLen);
+		static bool				isPrintableString(const char* inStringPtr, int maxLen);
+		static bool				isLetterString(const char* inStringPtr, int maxLen);
+		static bool				isNumberString(const char* inStringPtr, int maxLen);
+		static bool				isIntegerString(const char* inStringPtr, int maxLen);
+		static bool				isUnsignedIntegerString(const char* inStringPtr, int maxLen);
+		// index of the first delimiter, terminator, or non printable char, maxLen if none
+		static int				scanTokenBoundary(const char* inStringPtr, int maxLen);
+
+		// Token Byte Order Functions
+		static bool				isHostByteOrder(enum SPDByteOrderEnum byteOrder);
+		static void				swapTokenByteOrder(uint8_t* bytesPtr, int numTokens, int tokenSize);
+
+		/*! \fn CRC32C
+			\brief CRC-32C (Castagnoli) of a byte range, continued from crcIn (0 to start)
+
+			SSE4.2 crc32 instructions when the build targets them, slicing-by-8 tables otherwise.
+			The check value of "123456789" is 0xE3069283.
+		*/
+		static uint32_t			CRC32C(const uint8_t* bytesPtr, int numBytes, uint32_t crcIn = 0);
+
 	};
 
 }
@@ -0,0 +1,274 @@
+/*! \file  1_PacketView.h
+	\brief Non-virtual Packet Access over Arbitrary Token Buffers
+
+*/
+
+#ifndef __PACKETVIEW__
+#define __PACKETVIEW__
+#include "1_StructMarshal.h"
+
+namespace IMSPacketsAPICore
+{
+	/*! \addtogroup LanguageConstructs
+		@{
+	*/
+
+	/*! \class PacketView
+		\brief A trivially copyable view of a token buffer, structured by a packet class
+
+		Schema is a packet class declared with TEMPLATE_STATICPACKETINFO_H and TEMPLATE_SPDFIELD_H,
+		it is never instantiated.  A view holds only buffer pointers and sizes, so any byte or char
+		buffer (an interface buffer, a receive buffer, a mapped log, a shared memory slot) is read
+		and written in place, without binding it to a Packet object or making virtual calls.
+
+		Tokens are exchanged through the Field_X types of the schema:
+		\code
+		SPD4 x_SPD;
+		PacketView<Packet_HDRPACK> hView(rxBytesPtr, rxBytesCount, sizeof(SPD4));
+		if (hView.isSchemaPacket() && hView.readbuff<Packet_HDRPACK::Field_PacketType>(&x_SPD))
+			...
+		\endcode
+
+		Buffer sizes of -1 are unknown, the accesses are then bounded by the schema only.
+	*/
+	template<class Schema>
+	class PacketView
+	{
+	private:
+		uint8_t*	bytesBufferPtr = nullptr;
+		char*		charsBufferPtr = nullptr;
+		int			bytesBufferSize = -1;
+		int			charsBufferSize = -1;
+		int			bytesTokenSize = 0;
+		const struct PacketTokenSpan*	charsSpansPtr = nullptr;
+
+		inline bool	isInBytesBuffer(int byteOffset, int numBytes) const { return (bytesBufferPtr != nullptr && (bytesBufferSize < 0 || byteOffset + numBytes <= bytesBufferSize)); }
+		inline bool	isInCharsBuffer(int charOffset, int numChars) const { return (charsBufferPtr != nullptr && (charsBufferSize < 0 || charOffset + numChars <= charsBufferSize)); }
+		static constexpr int	TokenStringOffset(int i) { return STRINGBUFFER_IDTOKENRATIO + (i - 1) * STRINGBUFFER_TOKENRATIO; }
+		// token string i and its terminator, in its slot or at its span
+		inline bool	isTokenStringInCharsBuffer(int i) const
+		{
+			if (charsSpansPtr != nullptr)
+				return (charsSpansPtr[i].Length > 0 && isInCharsBuffer(charsSpansPtr[i].Offset, charsSpansPtr[i].Length + 1));
+			return isInCharsBuffer(TokenStringOffset(i), STRINGBUFFER_TOKENRATIO);
+		}
+		inline const char*	getTokenStringPtr(int i) const { return charsBufferPtr + ((charsSpansPtr != nullptr) ? charsSpansPtr[i].Offset : TokenStringOffset(i)); }
+
+	public:
+		PacketView() = default;
+		PacketView(uint8_t* bytesBufferPtrIn, int bytesBufferSizeIn, int bytesTokenSizeIn) :
+			bytesBufferPtr(bytesBufferPtrIn), bytesBufferSize(bytesBufferSizeIn), bytesTokenSize(bytesTokenSizeIn) { ; }
+		PacketView(char* charsBufferPtrIn, int charsBufferSizeIn) :
+			charsBufferPtr(charsBufferPtrIn), charsBufferSize(charsBufferSizeIn) { ; }
+		//! A view of a compact chars buffer, its token strings located by a table of spans (read only)
+		PacketView(char* charsBufferPtrIn, int charsBufferSizeIn, const struct PacketTokenSpan* charsSpansPtrIn) :
+			charsBufferPtr(charsBufferPtrIn), charsBufferSize(charsBufferSizeIn), charsSpansPtr(charsSpansPtrIn) { ; }
+		//! A view of the token buffers a Packet is bound to
+		explicit PacketView(Packet* PacketPtr) :
+			bytesBufferPtr(PacketPtr->getBytesBuffer()), charsBufferPtr(PacketPtr->getCharsBuffer()),
+			bytesBufferSize(PacketPtr->getBytesBufferSize()), charsBufferSize(PacketPtr->getCharsBufferSize()),
+			bytesTokenSize(PacketPtr->getBytesTokenSize()), charsSpansPtr(PacketPtr->getCharsSpans()) { ; }
+
+		inline uint8_t*	getBytesBuffer() const { return bytesBufferPtr; }
+		inline char*	getCharsBuffer() const { return charsBufferPtr; }
+		inline bool		isASCIIPacket() const { return (charsBufferPtr != nullptr); }
+
+		//! The unsigned ID token of the bytes buffer, -1 if the token size is unknown
+		inline int		ByteBuffer_ID() const
+		{
+			SPD1 x_SPD1; SPD2 x_SPD2; SPD4 x_SPD4; SPD8 x_SPD8;
+			if (!isInBytesBuffer(0, bytesTokenSize))
+				return -1;
+			switch (bytesTokenSize)
+			{
+			case sizeof(SPD1):	memcpy(&x_SPD1, bytesBufferPtr, sizeof(SPD1)); return x_SPD1.uintVal;
+			case sizeof(SPD2):	memcpy(&x_SPD2, bytesBufferPtr, sizeof(SPD2)); return x_SPD2.uintVal;
+			case sizeof(SPD4):	memcpy(&x_SPD4, bytesBufferPtr, sizeof(SPD4)); return (int)x_SPD4.uintVal;
+			case sizeof(SPD8):	memcpy(&x_SPD8, bytesBufferPtr, sizeof(SPD8)); return (int)x_SPD8.uintVal;
+			default:			return -1;
+			}
+		}
+		//! True if the buffer holds a packet of the Schema ID (string or token)
+		inline bool		isSchemaPacket() const
+		{
+			if (isASCIIPacket())
+				return (isInCharsBuffer(0, STRINGBUFFER_IDTOKENRATIO) && Packet::IDStringSlot_Equals(charsBufferPtr, Schema::IDString, Schema::IDStringLength));
+			return (ByteBuffer_ID() == Schema::ID);
+		}
+
+		// compile-time indexed exchange of binary tokens, a single load or store (or copy for array fields)
+		template<class Field, class TokenType>
+		inline bool		readbuff(TokenType* SPDPtr) const
+		{
+			static_assert(SPDTokenTraits<TokenType>::isSPD, "token type must be SPD1, SPD2, SPD4, or SPD8");
+			static_assert(Field::PacketTokenCount == Schema::TokenCount, "field must belong to the view schema");
+			if (!isInBytesBuffer(Field::template ByteOffset<TokenType>(), Field::Count * sizeof(TokenType)))
+				return false;
+			memcpy(SPDPtr, bytesBufferPtr + Field::template ByteOffset<TokenType>(), Field::Count * sizeof(TokenType));
+			return true;
+		}
+		template<class Field, class TokenType>
+		inline bool		writebuff(TokenType* SPDPtr) const
+		{
+			static_assert(SPDTokenTraits<TokenType>::isSPD, "token type must be SPD1, SPD2, SPD4, or SPD8");
+			static_assert(Field::PacketTokenCount == Schema::TokenCount, "field must belong to the view schema");
+			if (!isInBytesBuffer(Field::template ByteOffset<TokenType>(), Field::Count * sizeof(TokenType)))
+				return false;
+			memcpy(bytesBufferPtr + Field::template ByteOffset<TokenType>(), SPDPtr, Field::Count * sizeof(TokenType));
+			return true;
+		}
+
+		// compile-time indexed exchange of token strings, parsed and formatted according to the field type
+		template<class Field, class TokenType>
+		inline bool		getfromString(TokenType* SPDPtr) const
+		{
+			static_assert(Field::Index > Index_PackID, "the ID token is compared, not parsed");
+			static_assert(Field::PacketTokenCount == Schema::TokenCount, "field must belong to the view schema");
+			for (int i = 0; i < Field::Count; i++)
+				if (!isTokenStringInCharsBuffer(Field::Index + i) || !Packet::getSPDfromTokenString(getTokenStringPtr(Field::Index + i), SPDPtr + i, Field::ValType))
+					return false;
+			return true;
+		}
+		template<class Field, class TokenType>
+		inline bool		set2String(TokenType* SPDPtr, struct TokenFormatSpec fSpec) const
+		{
+			static_assert(Field::Index > Index_PackID, "the ID token is written by writebuff_PackIDString");
+			static_assert(Field::PacketTokenCount == Schema::TokenCount, "field must belong to the view schema");
+			if (charsSpansPtr != nullptr || !isInCharsBuffer(TokenStringOffset(Field::Index), Field::Count * STRINGBUFFER_TOKENRATIO) || !TokenStringCodec::isFormatOfType(fSpec, Field::ValType))
+				return false;
+			for (int i = 0; i < Field::Count; i++)
+				if (!Packet::setTokenStringfromSPD(charsBufferPtr + TokenStringOffset(Field::Index + i), SPDPtr + i, Field::ValType, fSpec))
+					return false;
+			return true;
+		}
+		//! Formatted "%d" for integer fields, shortest round-trip for floating point fields
+		template<class Field, class TokenType>
+		inline bool		set2String(TokenType* SPDPtr) const
+		{
+			constexpr struct TokenFormatSpec fSpec = { (Field::ValType == typeFLT) ? fmtConv_General : fmtConv_Decimal, -1 };
+			return set2String<Field>(SPDPtr, fSpec);
+		}
+
+		// whole struct exchange, for schemas declared with TEMPLATE_SPDSTRUCT_H
+		template<class TokenType, class S = Schema>
+		inline bool		packStruct(const typename S::StructType* StructPtr) const { return S::StructMap::template PackBytes<TokenType>(StructPtr, bytesBufferPtr, bytesBufferSize); }
+		template<class TokenType, class S = Schema>
+		inline bool		unpackStruct(typename S::StructType* StructPtr) const { return S::StructMap::template UnpackBytes<TokenType>(StructPtr, bytesBufferPtr, bytesBufferSize); }
+		template<class S = Schema>
+		inline bool		packStructString(const typename S::StructType* StructPtr) const { return (charsSpansPtr == nullptr && S::StructMap::PackChars(StructPtr, charsBufferPtr, charsBufferSize)); }
+		template<class S = Schema>
+		inline bool		unpackStructString(typename S::StructType* StructPtr) const { return (charsSpansPtr == nullptr && S::StructMap::UnpackChars(StructPtr, charsBufferPtr, charsBufferSize)); }
+
+		// header token strings of the Schema
+		inline bool		writebuff_PackIDString() const
+		{
+			if (charsSpansPtr != nullptr || !isInCharsBuffer(0, STRINGBUFFER_IDTOKENRATIO))
+				return false;
+			memcpy(charsBufferPtr, Schema::IDString, STRINGBUFFER_IDTOKENRATIO);
+			return true;
+		}
+		inline bool		writebuff_TokenCountString() const
+		{
+			return (charsSpansPtr == nullptr && isInCharsBuffer(TokenStringOffset(Index_PackLEN), STRINGBUFFER_TOKENRATIO)
+				&& TokenStringCodec::FormatSigned(charsBufferPtr + TokenStringOffset(Index_PackLEN), STRINGBUFFER_TOKENRATIO, Schema::TokenCount, TokenStringCodec::ParseFormat("%d")) > 0);
+		}
+	};
+
+	/*! \class PacketEmitter
+		\brief Single pass formatting of a Schema packet, in wire order, to a compact char buffer
+
+		The transmit-only alternative to set2String and SerializePacket_ASCII.  Construction emits the
+		ID string and token count, each emit formats the next field of the schema after the previous
+		delimiter, and finish terminates the packet.  No token slots are written, shifted, or parsed.
+		\code
+		PacketEmitter<Packet_HDRPACK> hEmitter(txCharsPtr, txCharsCount);
+		hEmitter.emit<Packet_HDRPACK::Field_PacketType>(&x_SPD);
+		hEmitter.emit<Packet_HDRPACK::Field_PacketOption>(&y_SPD);
+		serializedPacketSize = hEmitter.finish();
+		\endcode
+
+		Fields are emitted in index order, each token is formatted as set2String would (at most
+		STRINGBUFFER_TOKENRATIO-1 chars).  Any error, including a field out of order, latches until
+		finish, which then returns -1.
+	*/
+	template<class Schema>
+	class PacketEmitter
+	{
+	private:
+		char*		charsBufferPtr = nullptr;
+		int			charsBufferSize = 0;
+		int			CharCount = 0;
+		int			TokenIndex = 0;		// index of the next token emitted
+		bool		isError = false;
+
+		// a token is formatted to the buffer then delimited in place of its terminator
+		inline bool	emitDelimiter()
+		{
+			const char* terminatorPtr = (const char*)memchr(charsBufferPtr + CharCount, 0x00, STRINGBUFFER_TOKENRATIO);
+			if (terminatorPtr == nullptr)
+				return false;
+			CharCount = (int)(terminatorPtr - charsBufferPtr);
+			charsBufferPtr[CharCount++] = ASCII_colon;
+			TokenIndex++;
+			return true;
+		}
+
+	public:
+		PacketEmitter(char* charsBufferPtrIn, int charsBufferSizeIn) :
+			charsBufferPtr(charsBufferPtrIn), charsBufferSize(charsBufferSizeIn)
+		{
+			if (charsBufferPtr == nullptr || Schema::IDStringLength + 1 + STRINGBUFFER_TOKENRATIO > charsBufferSize)
+			{
+				isError = true;
+				return;
+			}
+			constexpr struct TokenFormatSpec countSpec = { fmtConv_Decimal, -1 };
+			memcpy(charsBufferPtr, Schema::IDString, Schema::IDStringLength);
+			CharCount = Schema::IDStringLength;
+			charsBufferPtr[CharCount++] = ASCII_colon;
+			TokenIndex = Index_PackLEN;
+			isError = !(TokenStringCodec::FormatSigned(charsBufferPtr + CharCount, STRINGBUFFER_TOKENRATIO, Schema::TokenCount, countSpec) > 0 && emitDelimiter());
+		}
+
+		template<class Field, class TokenType>
+		inline bool		emit(TokenType* SPDPtr, struct TokenFormatSpec fSpec)
+		{
+			static_assert(Field::Index > Index_PackLEN, "the ID string and token count are emitted at construction");
+			static_assert(Field::PacketTokenCount == Schema::TokenCount, "field must belong to the emitter schema");
+			if (isError || Field::Index != TokenIndex || !TokenStringCodec::isFormatOfType(fSpec, Field::ValType))
+				isError = true;
+			for (int i = 0; !isError && i < Field::Count; i++)
+			{
+				if (CharCount + STRINGBUFFER_TOKENRATIO > charsBufferSize
+					|| !Packet::setTokenStringfromSPD(charsBufferPtr + CharCount, SPDPtr + i, Field::ValType, fSpec) || !emitDelimiter())
+					isError = true;
+			}
+			return !isError;
+		}
+		//! Formatted "%d" for integer fields, shortest round-trip for floating point fields
+		template<class Field, class TokenType>
+		inline bool		emit(TokenType* SPDPtr)
+		{
+			constexpr struct TokenFormatSpec fSpec = { (Field::ValType == typeFLT) ? fmtConv_General : fmtConv_Decimal, -1 };
+			return emit<Field>(SPDPtr, fSpec);
+		}
+
+		/*! \fn finish
+			\brief Terminate the packet once every token is emitted
+			\return The count of chars of the serialized packet, -1 on error
+		*/
+		inline int		finish()
+		{
+			if (isError || TokenIndex != Schema::TokenCount || CharCount + 1 > charsBufferSize)
+				return -1;
+			charsBufferPtr[CharCount - 1] = ASCII_semicolon;
+			charsBufferPtr[CharCount++] = ASCII_lf;
+			isError = true;		// finished once
+			return CharCount;
+		}
+	};
+
+	/*! @}*/
+}
+
+#endif // !__PACKETVIEW__
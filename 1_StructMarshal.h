@@ -0,0 +1,264 @@
+/*! \file  1_StructMarshal.h
+	\brief Whole Struct Exchange between Packet Structs and Token Buffers
+
+*/
+
+#ifndef __STRUCTMARSHAL__
+#define __STRUCTMARSHAL__
+#include "1_LanguageConstructs.h"
+#include <cstddef>		// offsetof()
+#include <type_traits>
+
+/*! \addtogroup LanguageConstructs
+	@{
+*/
+
+/*! \def SPDSTRUCTMEMBER(structType, memberName, tokenName)
+	\brief Descriptor of a struct member exchanged with the schema field Field_tokenName
+*/
+#define SPDSTRUCTMEMBER(structType, memberName, tokenName) SPDStructMember<Field_##tokenName, decltype(structType::memberName), offsetof(structType, memberName)>
+
+/*! \def TEMPLATE_SPDSTRUCT_H(structType, ...)
+	\brief Code Template for Whole Struct Packet Accessors
+
+	This template declares, inside a packet class, the struct map of the packet struct
+	(a list of SPDSTRUCTMEMBER descriptors) and the inlined accessor templates
+	-packStruct(const structType*), struct to bytes buffer
+	-unpackStruct(structType*), bytes buffer to struct
+	-packStructString(const structType*), struct to chars buffer
+	-unpackStructString(structType*), chars buffer to struct
+
+	When the members are laid out as their tokens (same width, same order, no padding)
+	the binary accessors are a single copy.  It must follow the TEMPLATE_SPDFIELD_H
+	declarations of the mapped fields.  The string accessors read and write the fixed token
+	slots, so they fail on a packet received in the compact (span table) layout.
+*/
+#define TEMPLATE_SPDSTRUCT_H(structType, ...)\
+typedef structType StructType;\
+typedef SPDStructMap<structType, __VA_ARGS__> StructMap;\
+template<class TokenType> inline bool packStruct(const structType* myStruct){return StructMap::template PackBytes<TokenType>(myStruct, getBytesBuffer(), getBytesBufferSize());}\
+template<class TokenType> inline bool unpackStruct(structType* myStruct){return StructMap::template UnpackBytes<TokenType>(myStruct, getBytesBuffer(), getBytesBufferSize());}\
+inline bool packStructString(const structType* myStruct){return (getCharsSpans() == nullptr && StructMap::PackChars(myStruct, getCharsBuffer(), getCharsBufferSize()));}\
+inline bool unpackStructString(structType* myStruct){return (getCharsSpans() == nullptr && StructMap::UnpackChars(myStruct, getCharsBuffer(), getCharsBufferSize()));}\
+
+
+/*! @} */
+
+namespace IMSPacketsAPICore
+{
+	/*! \struct SPDTokenOfSize
+		\brief The token type of a struct member width, used to parse and format member token strings
+		\ingroup LanguageConstructs
+	*/
+	template<int numBytes> struct SPDTokenOfSize;
+	template<> struct SPDTokenOfSize<1> { typedef SPD1 Type; };
+	template<> struct SPDTokenOfSize<2> { typedef SPD2 Type; };
+	template<> struct SPDTokenOfSize<4> { typedef SPD4 Type; };
+	template<> struct SPDTokenOfSize<8> { typedef SPD8 Type; };
+
+	/*! \struct SPDStructMember
+		\brief Compile-time description of a struct member and the schema field it is exchanged with
+		\ingroup LanguageConstructs
+
+		Array members are exchanged with array fields of the same count.
+	*/
+	template<class Field, class MemberType, size_t MemberOffset>
+	struct SPDStructMember
+	{
+		typedef Field										FieldType;
+		typedef typename std::remove_extent<MemberType>::type	ElementType;
+		typedef typename SPDTokenOfSize<sizeof(ElementType)>::Type	ElementTokenType;
+		static const int									ElementCount = std::is_array<MemberType>::value ? (int)std::extent<MemberType>::value : 1;
+		static const size_t									Offset = MemberOffset;
+
+		static_assert(std::is_arithmetic<ElementType>::value, "struct members are arithmetic types, or arrays of them");
+		static_assert(ElementCount == Field::Count, "struct member and field must have the same number of tokens");
+
+		// a member element has the bits of its token, so it is copied as is
+		template<class TokenType>
+		static constexpr bool isTokenLayout()
+		{
+			if constexpr (sizeof(ElementType) != sizeof(TokenType))
+				return false;
+			else if constexpr (Field::ValType == typeFLT)
+				return (std::is_floating_point<ElementType>::value && std::is_floating_point<decltype(TokenType::fpVal)>::value);
+			else
+				return std::is_integral<ElementType>::value;
+		}
+
+		template<class TokenType>
+		static inline void toToken(const ElementType* elementPtr, TokenType* SPDPtr)
+		{
+			if constexpr (Field::ValType == typeFLT)
+				SPDPtr->fpVal = (decltype(SPDPtr->fpVal))(*elementPtr);
+			else if constexpr (Field::ValType == typeUINT)
+				SPDPtr->uintVal = (decltype(SPDPtr->uintVal))(*elementPtr);
+			else
+				SPDPtr->intVal = (decltype(SPDPtr->intVal))(*elementPtr);
+		}
+		template<class TokenType>
+		static inline void fromToken(ElementType* elementPtr, const TokenType* SPDPtr)
+		{
+			if constexpr (Field::ValType == typeFLT)
+				*elementPtr = (ElementType)SPDPtr->fpVal;
+			else if constexpr (Field::ValType == typeUINT)
+				*elementPtr = (ElementType)SPDPtr->uintVal;
+			else
+				*elementPtr = (ElementType)SPDPtr->intVal;
+		}
+
+		// per token exchange, for members not laid out as their tokens
+		template<class TokenType>
+		static inline void PackBytes(const uint8_t* structPtr, uint8_t* bytesPtr)
+		{
+			TokenType x_SPD;
+			ElementType x_Element;
+			for (int i = 0; i < ElementCount; i++)
+			{
+				memcpy(&x_Element, structPtr + Offset + i * sizeof(ElementType), sizeof(ElementType));
+				x_SPD.uintVal = 0;
+				toToken(&x_Element, &x_SPD);
+				memcpy(bytesPtr + Field::template ByteOffset<TokenType>() + i * sizeof(TokenType), &x_SPD, sizeof(TokenType));
+			}
+		}
+		template<class TokenType>
+		static inline void UnpackBytes(uint8_t* structPtr, const uint8_t* bytesPtr)
+		{
+			TokenType x_SPD;
+			ElementType x_Element;
+			for (int i = 0; i < ElementCount; i++)
+			{
+				memcpy(&x_SPD, bytesPtr + Field::template ByteOffset<TokenType>() + i * sizeof(TokenType), sizeof(TokenType));
+				fromToken(&x_Element, &x_SPD);
+				memcpy(structPtr + Offset + i * sizeof(ElementType), &x_Element, sizeof(ElementType));
+			}
+		}
+
+		// token strings are parsed and formatted at the member width, "%d" or shortest round-trip
+		static inline bool PackChars(const uint8_t* structPtr, char* charsPtr)
+		{
+			constexpr struct TokenFormatSpec fSpec = { (Field::ValType == typeFLT) ? fmtConv_General : fmtConv_Decimal, -1 };
+			ElementTokenType x_SPD;
+			ElementType x_Element;
+			for (int i = 0; i < ElementCount; i++)
+			{
+				memcpy(&x_Element, structPtr + Offset + i * sizeof(ElementType), sizeof(ElementType));
+				toToken(&x_Element, &x_SPD);
+				if (!Packet::setTokenStringfromSPD(charsPtr + STRINGBUFFER_IDTOKENRATIO + (Field::Index + i - 1) * STRINGBUFFER_TOKENRATIO, &x_SPD, Field::ValType, fSpec))
+					return false;
+			}
+			return true;
+		}
+		static inline bool UnpackChars(uint8_t* structPtr, const char* charsPtr)
+		{
+			ElementTokenType x_SPD;
+			ElementType x_Element;
+			for (int i = 0; i < ElementCount; i++)
+			{
+				if (!Packet::getSPDfromTokenString(charsPtr + STRINGBUFFER_IDTOKENRATIO + (Field::Index + i - 1) * STRINGBUFFER_TOKENRATIO, &x_SPD, Field::ValType))
+					return false;
+				fromToken(&x_Element, &x_SPD);
+				memcpy(structPtr + Offset + i * sizeof(ElementType), &x_Element, sizeof(ElementType));
+			}
+			return true;
+		}
+	};
+
+	/*! \struct SPDStructMap
+		\brief Compile-time map of a packet struct to the tokens of a packet
+		\ingroup LanguageConstructs
+
+		Members are exchanged with a single copy when, for the token type, they are listed in
+		token order, occupy consecutive tokens, and are laid out in the struct as those tokens
+		are in the buffer.  Otherwise each member is converted to and from its token width.
+		Token strings are always exchanged member by member.  Buffer sizes of -1 are unknown,
+		the exchange is then bounded by the packet schema only.
+	*/
+	template<class StructType, class... Members>
+	struct SPDStructMap
+	{
+		static_assert(sizeof...(Members) > 0, "struct maps have at least one member");
+		static_assert(std::is_standard_layout<StructType>::value, "packet structs are standard layout");
+
+		static const int NumMembers = sizeof...(Members);
+
+		template<class TokenType>
+		static constexpr bool isSingleCopy()
+		{
+			constexpr int indexes[] = { Members::FieldType::Index... };
+			constexpr int counts[] = { Members::FieldType::Count... };
+			constexpr size_t offsets[] = { Members::Offset... };
+			constexpr bool isLayouts[] = { Members::template isTokenLayout<TokenType>()... };
+			int tokenCount = 0;
+			for (int i = 0; i < NumMembers; i++)
+			{
+				if (!isLayouts[i] || indexes[i] != indexes[0] + tokenCount || offsets[i] != offsets[0] + tokenCount * sizeof(TokenType))
+					return false;
+				tokenCount += counts[i];
+			}
+			return true;
+		}
+		static constexpr int TokenEnd()
+		{
+			constexpr int tokenEnds[] = { (Members::FieldType::Index + Members::FieldType::Count)... };
+			int tokenEnd = 0;
+			for (int i = 0; i < NumMembers; i++)
+				tokenEnd = (tokenEnds[i] > tokenEnd) ? tokenEnds[i] : tokenEnd;
+			return tokenEnd;
+		}
+		static constexpr int TokenBegin()
+		{
+			constexpr int indexes[] = { Members::FieldType::Index... };
+			int tokenBegin = indexes[0];
+			for (int i = 0; i < NumMembers; i++)
+				tokenBegin = (indexes[i] < tokenBegin) ? indexes[i] : tokenBegin;
+			return tokenBegin;
+		}
+		static constexpr int TokenCount() { return (Members::FieldType::Count + ...); }
+
+		template<class TokenType>
+		static bool PackBytes(const StructType* structPtr, uint8_t* bytesPtr, int bytesSize)
+		{
+			static_assert(SPDTokenTraits<TokenType>::isSPD, "token type must be SPD1, SPD2, SPD4, or SPD8");
+			constexpr int indexes[] = { Members::FieldType::Index... };
+			constexpr size_t offsets[] = { Members::Offset... };
+			if (structPtr == nullptr || bytesPtr == nullptr || (bytesSize > -1 && bytesSize < TokenEnd() * (int)sizeof(TokenType)))
+				return false;
+			if constexpr (isSingleCopy<TokenType>())
+				memcpy(bytesPtr + indexes[0] * sizeof(TokenType), (const uint8_t*)structPtr + offsets[0], TokenCount() * sizeof(TokenType));
+			else
+				(Members::template PackBytes<TokenType>((const uint8_t*)structPtr, bytesPtr), ...);
+			return true;
+		}
+		template<class TokenType>
+		static bool UnpackBytes(StructType* structPtr, const uint8_t* bytesPtr, int bytesSize)
+		{
+			static_assert(SPDTokenTraits<TokenType>::isSPD, "token type must be SPD1, SPD2, SPD4, or SPD8");
+			constexpr int indexes[] = { Members::FieldType::Index... };
+			constexpr size_t offsets[] = { Members::Offset... };
+			if (structPtr == nullptr || bytesPtr == nullptr || (bytesSize > -1 && bytesSize < TokenEnd() * (int)sizeof(TokenType)))
+				return false;
+			if constexpr (isSingleCopy<TokenType>())
+				memcpy((uint8_t*)structPtr + offsets[0], bytesPtr + indexes[0] * sizeof(TokenType), TokenCount() * sizeof(TokenType));
+			else
+				(Members::template UnpackBytes<TokenType>((uint8_t*)structPtr, bytesPtr), ...);
+			return true;
+		}
+		static bool PackChars(const StructType* structPtr, char* charsPtr, int charsSize)
+		{
+			static_assert(TokenBegin() > Index_PackID, "the ID token string is not a struct member");
+			if (structPtr == nullptr || charsPtr == nullptr || (charsSize > -1 && charsSize < STRINGBUFFER_CHARCOUNT_OF(TokenEnd())))
+				return false;
+			return (Members::PackChars((const uint8_t*)structPtr, charsPtr) && ...);
+		}
+		static bool UnpackChars(StructType* structPtr, const char* charsPtr, int charsSize)
+		{
+			static_assert(TokenBegin() > Index_PackID, "the ID token string is not a struct member");
+			if (structPtr == nullptr || charsPtr == nullptr || (charsSize > -1 && charsSize < STRINGBUFFER_CHARCOUNT_OF(TokenEnd())))
+				return false;
+			return (Members::UnpackChars((uint8_t*)structPtr, charsPtr) && ...);
+		}
+	};
+}
+
+#endif // !__STRUCTMARSHAL__
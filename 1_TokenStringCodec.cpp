@@ -0,0 +1,118 @@
+#include "1_LanguageConstructs.h"
+using namespace IMSPacketsAPICore;
+
+#pragma region TokenStringCodec Implementation
+
+// terminate a converted token, or fail if no room remains for the terminator
+static int TerminateTokenString(char* dstPtr, int dstLen, std::to_chars_result convResult)
+{
+	if (convResult.ec != std::errc() || convResult.ptr >= dstPtr + dstLen)
+		return -1;
+	convResult.ptr[0] = 0x00;
+	return (int)(convResult.ptr - dstPtr);
+}
+
+// insert a prefix after the sign of a converted token, then zeros up to its width or the end of the slot
+static int PrefixTokenString(char* dstPtr, int dstLen, int charCount, const char* prefixPtr, struct TokenFormatSpec fSpec)
+{
+	int prefixLen = (int)strlen(prefixPtr);
+	int signLen = (charCount > 0 && dstPtr[0] == ASCII_minus) ? 1 : 0;
+	int padWidth = (fSpec.Width < dstLen - 1) ? fSpec.Width : dstLen - 1;
+	int zeroCount = ((fSpec.Flags & fmtFlag_ZeroPad) && padWidth > charCount + prefixLen) ? padWidth - charCount - prefixLen : 0;
+	if (charCount < 0 || charCount + prefixLen + zeroCount >= dstLen)
+		return -1;
+	memmove(dstPtr + signLen + prefixLen + zeroCount, dstPtr + signLen, charCount - signLen + 1);
+	memcpy(dstPtr + signLen, prefixPtr, prefixLen);
+	memset(dstPtr + signLen + prefixLen, ASCII_0, zeroCount);
+	return charCount + prefixLen + zeroCount;
+}
+
+bool TokenStringCodec::ParseUnsigned(const char* tokenPtr, int maxLen, uint64_t* valPtr)
+{
+	const char* lastPtr = tokenPtr + maxLen;
+	if (maxLen < 1 || tokenPtr[0] == 0x00)
+		return false;
+	if (tokenPtr[0] == ASCII_plus)
+		tokenPtr++;
+	std::from_chars_result convResult = std::from_chars(tokenPtr, lastPtr, *valPtr, 10);
+	return (convResult.ec == std::errc() && (convResult.ptr == lastPtr || convResult.ptr[0] == 0x00));
+}
+bool TokenStringCodec::ParseSigned(const char* tokenPtr, int maxLen, int64_t* valPtr)
+{
+	const char* lastPtr = tokenPtr + maxLen;
+	if (maxLen < 1 || tokenPtr[0] == 0x00)
+		return false;
+	if (tokenPtr[0] == ASCII_plus && maxLen > 1 && tokenPtr[1] != ASCII_minus)
+		tokenPtr++;
+	std::from_chars_result convResult = std::from_chars(tokenPtr, lastPtr, *valPtr, 10);
+	return (convResult.ec == std::errc() && (convResult.ptr == lastPtr || convResult.ptr[0] == 0x00));
+}
+bool TokenStringCodec::ParseFloat(const char* tokenPtr, int maxLen, double* valPtr)
+{
+	const char* lastPtr = tokenPtr + maxLen;
+	if (maxLen < 1 || tokenPtr[0] == 0x00)
+		return false;
+	if (tokenPtr[0] == ASCII_plus && maxLen > 1 && tokenPtr[1] != ASCII_minus)
+		tokenPtr++;
+	std::from_chars_result convResult = std::from_chars(tokenPtr, lastPtr, *valPtr, std::chars_format::general);
+	return (convResult.ec == std::errc() && (convResult.ptr == lastPtr || convResult.ptr[0] == 0x00) && std::isfinite(*valPtr));
+}
+
+int TokenStringCodec::FormatUnsigned(char* dstPtr, int dstLen, uint64_t val, struct TokenFormatSpec fSpec)
+{
+	int charCount;
+	bool isPrefixed = ((fSpec.Flags & fmtFlag_Alternate) && val != 0);
+	switch (fSpec.Conversion)
+	{
+	case fmtConv_Decimal:	charCount = TerminateTokenString(dstPtr, dstLen, std::to_chars(dstPtr, dstPtr + dstLen, val, 10));	break;
+	case fmtConv_Octal:		return PrefixTokenString(dstPtr, dstLen, TerminateTokenString(dstPtr, dstLen, std::to_chars(dstPtr, dstPtr + dstLen, val, 8)), isPrefixed ? "0" : "", fSpec);
+	case fmtConv_HexLower:	return PrefixTokenString(dstPtr, dstLen, TerminateTokenString(dstPtr, dstLen, std::to_chars(dstPtr, dstPtr + dstLen, val, 16)), isPrefixed ? "0x" : "", fSpec);
+	case fmtConv_HexUpper:
+		charCount = TerminateTokenString(dstPtr, dstLen, std::to_chars(dstPtr, dstPtr + dstLen, val, 16));
+		for (int i = 0; i < charCount; i++)
+			if (dstPtr[i] >= ASCII_a)
+				dstPtr[i] -= (ASCII_a - ASCII_A);
+		return PrefixTokenString(dstPtr, dstLen, charCount, isPrefixed ? "0X" : "", fSpec);
+	default:				return -1;
+	}
+	// unsigned tokens are never signed, the '+' flag is for signed and floating point tokens
+	return PrefixTokenString(dstPtr, dstLen, charCount, "", fSpec);
+}
+int TokenStringCodec::FormatSigned(char* dstPtr, int dstLen, int64_t val, struct TokenFormatSpec fSpec)
+{
+	if (fSpec.Conversion == fmtConv_Decimal)
+		return PrefixTokenString(dstPtr, dstLen, TerminateTokenString(dstPtr, dstLen, std::to_chars(dstPtr, dstPtr + dstLen, val, 10)), ((fSpec.Flags & fmtFlag_Plus) && val >= 0) ? "+" : "", fSpec);
+	return FormatUnsigned(dstPtr, dstLen, (uint64_t)val, fSpec);
+}
+int TokenStringCodec::FormatFloat(char* dstPtr, int dstLen, float val, struct TokenFormatSpec fSpec)
+{
+	std::chars_format charsFormat;
+	switch (fSpec.Conversion)
+	{
+	case fmtConv_Fixed:			charsFormat = std::chars_format::fixed;			break;
+	case fmtConv_Scientific:	charsFormat = std::chars_format::scientific;	break;
+	case fmtConv_General:		charsFormat = std::chars_format::general;		break;
+	default:					return -1;
+	}
+	const char* signPtr = ((fSpec.Flags & fmtFlag_Plus) && !std::signbit(val)) ? "+" : "";
+	if (fSpec.Precision < 0) // shortest round-trip representation in the requested notation
+		return PrefixTokenString(dstPtr, dstLen, TerminateTokenString(dstPtr, dstLen, std::to_chars(dstPtr, dstPtr + dstLen, val, charsFormat)), signPtr, fSpec);
+	return PrefixTokenString(dstPtr, dstLen, TerminateTokenString(dstPtr, dstLen, std::to_chars(dstPtr, dstPtr + dstLen, val, charsFormat, fSpec.Precision)), signPtr, fSpec);
+}
+int TokenStringCodec::FormatFloat(char* dstPtr, int dstLen, double val, struct TokenFormatSpec fSpec)
+{
+	std::chars_format charsFormat;
+	switch (fSpec.Conversion)
+	{
+	case fmtConv_Fixed:			charsFormat = std::chars_format::fixed;			break;
+	case fmtConv_Scientific:	charsFormat = std::chars_format::scientific;	break;
+	case fmtConv_General:		charsFormat = std::chars_format::general;		break;
+	default:					return -1;
+	}
+	const char* signPtr = ((fSpec.Flags & fmtFlag_Plus) && !std::signbit(val)) ? "+" : "";
+	if (fSpec.Precision < 0) // shortest round-trip representation in the requested notation
+		return PrefixTokenString(dstPtr, dstLen, TerminateTokenString(dstPtr, dstLen, std::to_chars(dstPtr, dstPtr + dstLen, val, charsFormat)), signPtr, fSpec);
+	return PrefixTokenString(dstPtr, dstLen, TerminateTokenString(dstPtr, dstLen, std::to_chars(dstPtr, dstPtr + dstLen, val, charsFormat, fSpec.Precision)), signPtr, fSpec);
+}
+
+#pragma endregion
@@ -0,0 +1,180 @@
+/*! \file  1_TokenStringCodec.h
+	\brief Text Encoding of Serial Parameter Data Tokens
+
+*/
+
+#ifndef __TOKENSTRINGCODEC__
+#define __TOKENSTRINGCODEC__
+#include "0_EcoSystemRestrictions.h"
+
+namespace IMSPacketsAPICore
+{
+	/*! \addtogroup LanguageConstructs
+		@{
+	*/
+
+	/*! \brief SPD data type encoding
+	*/
+	enum SPDValTypeEnum
+	{
+		typeUINT,
+		typeINT,
+		typeFLT
+	};
+
+	/*! \brief Token string conversions supported by the string codec */
+	enum TokenFormatConversion
+	{
+		fmtConv_Invalid,
+		fmtConv_Decimal,
+		fmtConv_HexLower,
+		fmtConv_HexUpper,
+		fmtConv_Octal,
+		fmtConv_Fixed,
+		fmtConv_Scientific,
+		fmtConv_General
+	};
+
+	/*! \brief Token string flags supported by the string codec */
+	enum TokenFormatFlag
+	{
+		fmtFlag_Plus		= 0x01,		// '+' sign on non-negative signed and floating point tokens
+		fmtFlag_Alternate	= 0x02,		// 0x, 0X, or 0 prefix on non-zero hex and octal tokens
+		fmtFlag_ZeroPad		= 0x04		// zeros after the sign and prefix, up to the width
+	};
+
+	/*! \struct TokenFormatSpec
+		\brief A printf style token format string, parsed
+
+		Precision is -1 when the format string has none.  Floating point
+		conversions without a precision are written in their shortest
+		round-trip representation.  Width is 0 when the format string has
+		none, and only pads tokens with the fmtFlag_ZeroPad flag.
+	*/
+	struct TokenFormatSpec
+	{
+		enum TokenFormatConversion	Conversion;
+		int							Precision;
+		int							Width	= 0;
+		int							Flags	= 0;
+	};
+
+	/*! \class TokenStringCodec
+		\brief Single pass conversion between token strings and token values
+
+		Token strings are the fixed length char slots of an ASCII packet buffer.  Parsing
+		validates and converts in one pass over at most maxLen chars, stopping at the first
+		0x00, and is independent of the locale.  Integers are parsed to their full 64 bit
+		range; range checks for narrower tokens are left to the caller.  Formatting writes
+		at most dstLen chars, including the 0x00 terminator, and fails rather than truncates.
+
+		Format strings are parsed by a constexpr function so the token accessor templates
+		parse and validate them at compile time.  Supported format strings are
+		- "%d", "%i", "%u", "%x", "%X", "%o" for integer tokens
+		- "%f", "%e", "%g", with an optional ".precision", for floating point tokens
+
+		with optional flags and width before the precision, and optional length modifiers
+		(h, l, ll, ...), which are ignored.  The '+', '#', and '0' flags are honored, a zero
+		padded token is padded to its width or to the end of its slot, whichever is shorter.
+		Token strings are delimited and parsed without whitespace, so the ' ' and '-' flags,
+		and widths without the '0' flag, are parsed and ignored.
+	*/
+	class TokenStringCodec
+	{
+	public:
+		static constexpr struct TokenFormatSpec ParseFormat(const char* fString)
+		{
+			struct TokenFormatSpec fSpec = { fmtConv_Invalid, -1 };
+			struct TokenFormatSpec invalidSpec = { fmtConv_Invalid, -1 };
+			bool leftJustified = false;
+			int i = 0;
+			if (fString == nullptr || fString[i++] != '%')
+				return invalidSpec;
+
+			// optional flags, those padding with spaces are ignored
+			while (fString[i] == '-' || fString[i] == '+' || fString[i] == ' ' || fString[i] == '#' || fString[i] == '0')
+			{
+				switch (fString[i++])
+				{
+				case '+':	fSpec.Flags |= fmtFlag_Plus;		break;
+				case '#':	fSpec.Flags |= fmtFlag_Alternate;	break;
+				case '0':	fSpec.Flags |= fmtFlag_ZeroPad;		break;
+				case '-':	leftJustified = true;				break;
+				default:										break;
+				}
+			}
+			if (leftJustified)
+				fSpec.Flags &= ~fmtFlag_ZeroPad;
+
+			// optional width, a minimum only
+			while (fString[i] >= '0' && fString[i] <= '9')
+			{
+				if (fSpec.Width < STRINGBUFFER_TOKENRATIO)
+					fSpec.Width = fSpec.Width * 10 + (fString[i] - '0');
+				i++;
+			}
+			if ((fSpec.Flags & fmtFlag_ZeroPad) == 0)
+				fSpec.Width = 0;
+
+			// optional precision
+			if (fString[i] == '.')
+			{
+				i++;
+				if (fString[i] < '0' || fString[i] > '9')
+					return invalidSpec;
+				fSpec.Precision = 0;
+				while (fString[i] >= '0' && fString[i] <= '9')
+					fSpec.Precision = fSpec.Precision * 10 + (fString[i++] - '0');
+			}
+
+			// length modifiers are ignored, the token type sets the width
+			while (fString[i] == 'h' || fString[i] == 'l' || fString[i] == 'L' || fString[i] == 'j' || fString[i] == 'z' || fString[i] == 't')
+				i++;
+
+			switch (fString[i])
+			{
+			case 'd': case 'i': case 'u':	fSpec.Conversion = fmtConv_Decimal;		break;
+			case 'x':						fSpec.Conversion = fmtConv_HexLower;	break;
+			case 'X':						fSpec.Conversion = fmtConv_HexUpper;	break;
+			case 'o':						fSpec.Conversion = fmtConv_Octal;		break;
+			case 'f': case 'F':				fSpec.Conversion = fmtConv_Fixed;		break;
+			case 'e': case 'E':				fSpec.Conversion = fmtConv_Scientific;	break;
+			case 'g': case 'G':				fSpec.Conversion = fmtConv_General;		break;
+			default:						return invalidSpec;
+			}
+			if (fString[i + 1] != 0x00)
+				return invalidSpec;
+			if (isIntegerFormat(fSpec) && fSpec.Precision != -1)
+				return invalidSpec;
+			return fSpec;
+		}
+		static constexpr bool isIntegerFormat(struct TokenFormatSpec fSpec)
+		{
+			return (fSpec.Conversion == fmtConv_Decimal || fSpec.Conversion == fmtConv_HexLower || fSpec.Conversion == fmtConv_HexUpper || fSpec.Conversion == fmtConv_Octal);
+		}
+		static constexpr bool isFloatFormat(struct TokenFormatSpec fSpec)
+		{
+			return (fSpec.Conversion == fmtConv_Fixed || fSpec.Conversion == fmtConv_Scientific || fSpec.Conversion == fmtConv_General);
+		}
+
+		static constexpr bool isFormatOfType(struct TokenFormatSpec fSpec, enum SPDValTypeEnum dType)
+		{
+			return (dType == typeFLT) ? isFloatFormat(fSpec) : isIntegerFormat(fSpec);
+		}
+
+		// validate and convert, single pass
+		static bool		ParseUnsigned(const char* tokenPtr, int maxLen, uint64_t* valPtr);
+		static bool		ParseSigned(const char* tokenPtr, int maxLen, int64_t* valPtr);
+		static bool		ParseFloat(const char* tokenPtr, int maxLen, double* valPtr);
+
+		// convert and terminate, return count of chars written (less terminator), -1 on error
+		static int		FormatUnsigned(char* dstPtr, int dstLen, uint64_t val, struct TokenFormatSpec fSpec);
+		static int		FormatSigned(char* dstPtr, int dstLen, int64_t val, struct TokenFormatSpec fSpec);
+		static int		FormatFloat(char* dstPtr, int dstLen, float val, struct TokenFormatSpec fSpec);
+		static int		FormatFloat(char* dstPtr, int dstLen, double val, struct TokenFormatSpec fSpec);
+	};
+
+	/*! @}*/
+}
+
+#endif // !__TOKENSTRINGCODEC__
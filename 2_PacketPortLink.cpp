@@ -1,7 +1,66 @@
 #include "2_PacketPortLink.h"
+#include <algorithm>	// std::rotate()
 using namespace IMSPacketsAPICore;
 
 
+#pragma region PacketRxRing Implementation
+int		PacketRxRing::Write(const uint8_t* srcPtr, int numBytes)
+{
+	int numWritten = 0;
+	// at most two contiguous spans, before and after the wrap
+	while (numWritten < numBytes && getSpace() > 0)
+	{
+		int spanBytes = getContiguousSpace();
+		if (spanBytes > numBytes - numWritten)
+			spanBytes = numBytes - numWritten;
+		memcpy(getWritePtr(), srcPtr + numWritten, spanBytes);
+		CommitWrite(spanBytes);
+		numWritten += spanBytes;
+	}
+	return numWritten;
+}
+int		PacketRxRing::Read(uint8_t* dstPtr, int numBytes)
+{
+	int numRead = 0;
+	while (numRead < numBytes && !isEmpty())
+	{
+		int spanBytes = getContiguousCount();
+		if (spanBytes > numBytes - numRead)
+			spanBytes = numBytes - numRead;
+		memcpy(dstPtr + numRead, getReadPtr(), spanBytes);
+		Consume(spanBytes);
+		numRead += spanBytes;
+	}
+	return numRead;
+}
+void	PacketRxRing::Linearize()
+{
+	int numBytes = getCount();
+	if (getContiguousCount() == numBytes)
+		return;
+	std::rotate(&RingBytes[0], &RingBytes[Tail & RingMask], &RingBytes[PACKETINTERFACE_RXRINGSIZE]);
+	Tail = 0;
+	Head = (uint32_t)numBytes;
+}
+int		PacketRxRing::FillFromStream(std::istream* streamPtr)
+{
+	int numRead = 0;
+	// peek blocks only as a single byte read would, and refills the stream buffer for readsome
+	if (streamPtr == nullptr || getSpace() == 0 || streamPtr->peek() == EOF)
+		return 0;
+	while (getSpace() > 0)
+	{
+		int spanBytes = (int)streamPtr->readsome((char*)getWritePtr(), getContiguousSpace());
+		if (spanBytes <= 0)
+			break;
+		CommitWrite(spanBytes);
+		numRead += spanBytes;
+	}
+	return numRead;
+}
+#pragma endregion
+
+
 #pragma region PacketInterface Implementation
 PacketInterface::PacketInterface(std::iostream* ifaceStreamPtrIn)
 {
@@ -24,6 +83,15 @@ void	PacketInterface::WriteTo()
 		WriteToStream();
 	}
 }
+void	PacketInterface::FlushTo()
+{
+	if (ifaceStreamPtr != nullptr)
+		ifaceStreamPtr->flush();
+	else if (ifaceOutStreamPtr != nullptr)
+		ifaceOutStreamPtr->flush();
+	else
+		CustomFlushTo();
+}
 void	PacketInterface::ReadFrom()
 {
 	if (ifaceStreamPtr == nullptr && ifaceInStreamPtr == nullptr)
@@ -39,6 +107,111 @@ void	PacketInterface::ReadFrom()
 #pragma endregion
 
 
+#pragma region PacketOutQueue Implementation
+PacketOutQueue::PacketOutQueue(OutPackQueueSlot* SlotsPtrIn, std::atomic<uint32_t>* CoalesceIndexPtrIn, int CapacityIn, bool isMultiProducerIn) :
+	SlotsPtr(SlotsPtrIn), CoalesceIndexPtr(CoalesceIndexPtrIn), CapacityMask((uint32_t)CapacityIn - 1), isMultiProducer(isMultiProducerIn),
+	OverflowCount(0), CoalescedCount(0), Tail(0), Head(0)
+{
+	// a slot is free for the producer claiming count i when its sequence is i
+	for (uint32_t i = 0; i <= CapacityMask; i++)
+	{
+		SlotsPtr[i].Sequence.store(i, std::memory_order_relaxed);
+		SlotsPtr[i].CoalesceKey.store(0, std::memory_order_relaxed);
+	}
+	for (uint32_t i = 0; i < 2 * (CapacityMask + 1); i++)
+		CoalesceIndexPtr[i].store(0, std::memory_order_relaxed);
+}
+uint64_t PacketOutQueue::getCoalesceKey(const struct OutPackQueueStruct* EntryPtr)
+{
+	// ID + 1, type, and option packed exactly, 0 if they do not fit
+	if (EntryPtr->PackID < 0 || EntryPtr->PackID > (1 << 28) - 2 || (int)EntryPtr->packTYPE < 0 || (int)EntryPtr->packTYPE > 15)
+		return 0;
+	return ((uint64_t)(EntryPtr->PackID + 1) << 36) | ((uint64_t)EntryPtr->packTYPE << 32) | (uint64_t)(uint32_t)EntryPtr->packOPTION;
+}
+void PacketOutQueue::ClearCoalesceKey(OutPackQueueSlot* slotPtr)
+{
+	// a packet peeked is being packaged, identical packets enqueued from now on are sent again
+	if (slotPtr->CoalesceKey.load(std::memory_order_relaxed) != 0)
+		slotPtr->CoalesceKey.exchange(0, std::memory_order_acq_rel);
+}
+bool PacketOutQueue::Push(const struct OutPackQueueStruct* EntryPtr)
+{
+	// merge with an identical packet not yet peeked, its key is still in the slot the index refers to
+	uint64_t coalesceKey = 0;
+	std::atomic<uint32_t>* indexPtr = nullptr;
+	if (isCoalescing && (coalesceKey = getCoalesceKey(EntryPtr)) != 0)
+	{
+		indexPtr = &CoalesceIndexPtr[(uint32_t)((coalesceKey * 0x9E3779B97F4A7C15ull) >> 40) & (2 * CapacityMask + 1)];
+		uint32_t slotRef = indexPtr->load(std::memory_order_relaxed);
+		uint64_t expectedKey = coalesceKey;
+		if (slotRef != 0 && SlotsPtr[slotRef - 1].CoalesceKey.compare_exchange_strong(expectedKey, coalesceKey, std::memory_order_acq_rel))
+		{
+			CoalescedCount.fetch_add(1, std::memory_order_relaxed);
+			return true;
+		}
+	}
+
+	uint32_t tailCount = Tail.load(std::memory_order_relaxed);
+	OutPackQueueSlot* slotPtr;
+	while (true)
+	{
+		slotPtr = &SlotsPtr[tailCount & CapacityMask];
+		int32_t seqDiff = (int32_t)(slotPtr->Sequence.load(std::memory_order_acquire) - tailCount);
+		if (seqDiff < 0)
+			return false;	// not yet popped, the queue is full
+		if (seqDiff > 0)
+		{
+			tailCount = Tail.load(std::memory_order_relaxed);	// claimed by another producer
+			continue;
+		}
+		if (!isMultiProducer)
+		{
+			Tail.store(tailCount + 1, std::memory_order_relaxed);
+			break;
+		}
+		if (Tail.compare_exchange_weak(tailCount, tailCount + 1, std::memory_order_relaxed))
+			break;
+	}
+	slotPtr->Entry = *EntryPtr;
+	if (indexPtr != nullptr)
+	{
+		slotPtr->CoalesceKey.store(coalesceKey, std::memory_order_relaxed);
+		indexPtr->store((tailCount & CapacityMask) + 1, std::memory_order_relaxed);
+	}
+	slotPtr->Sequence.store(tailCount + 1, std::memory_order_release);
+	return true;
+}
+const struct OutPackQueueStruct* PacketOutQueue::Peek()
+{
+	uint32_t headCount = Head.load(std::memory_order_relaxed);
+	OutPackQueueSlot* slotPtr = &SlotsPtr[headCount & CapacityMask];
+	if (slotPtr->Sequence.load(std::memory_order_acquire) != headCount + 1)
+		return nullptr;		// empty, or claimed and not yet published
+	if (isCoalescing)
+		ClearCoalesceKey(slotPtr);
+	return &slotPtr->Entry;
+}
+void PacketOutQueue::Pop()
+{
+	uint32_t headCount = Head.load(std::memory_order_relaxed);
+	OutPackQueueSlot* slotPtr = &SlotsPtr[headCount & CapacityMask];
+	if (slotPtr->Sequence.load(std::memory_order_acquire) != headCount + 1)
+		return;
+	ClearCoalesceKey(slotPtr);
+	// free the slot for the producer of the next lap
+	slotPtr->Sequence.store(headCount + CapacityMask + 1, std::memory_order_release);
+	Head.store(headCount + 1, std::memory_order_relaxed);
+}
+int PacketOutQueue::getDepth()
+{
+	int depthVal = (int)(Tail.load(std::memory_order_acquire) - Head.load(std::memory_order_acquire));
+	if (depthVal < 0)
+		return 0;
+	return (depthVal > getCapacity()) ? getCapacity() : depthVal;
+}
+#pragma endregion
+
+
 #pragma region PolymorphicPacketPort Implementation
 PacketInterface* PolymorphicPacketPort::getInputInterface()
 {
@@ -50,56 +223,146 @@ PacketInterface* PolymorphicPacketPort::getOutputInterface()
 }
 int PolymorphicPacketPort::getPortID() { return PortID; }
 bool PolymorphicPacketPort::getAsyncService() { return ServiceAsync; }
+void PolymorphicPacketPort::setOutPacketQueue(PacketOutQueue* OutPacketQueueIn, enum PacketOutPriority outPriority)
+{
+	if (OutPacketQueueIn != nullptr && outPriority >= outPriority_High && outPriority <= outPriority_Low)
+	{
+		OutPacketLanes[outPriority] = OutPacketQueueIn;
+		OutLaneSelected = -1;
+	}
+}
+PacketOutQueue* PolymorphicPacketPort::getOutPacketQueue(enum PacketOutPriority outPriority)
+{
+	if (outPriority >= outPriority_High && outPriority <= outPriority_Low)
+		return OutPacketLanes[outPriority];
+	return nullptr;
+}
+void PolymorphicPacketPort::setOutScheduling(enum PacketOutScheduling outScheduling, int highWeight, int normalWeight, int lowWeight)
+{
+	OutScheduling = outScheduling;
+	OutLaneWeights[outPriority_High] = (highWeight > 0) ? highWeight : 1;
+	OutLaneWeights[outPriority_Normal] = (normalWeight > 0) ? normalWeight : 1;
+	OutLaneWeights[outPriority_Low] = (lowWeight > 0) ? lowWeight : 1;
+	for (int i = 0; i < OutPackLaneCount; i++)
+		OutLaneCredits[i] = 0;
+}
+enum PacketOutScheduling PolymorphicPacketPort::getOutScheduling() { return OutScheduling; }
+enum PacketOutPriority PolymorphicPacketPort::getDefaultOutPriority(enum PacketTypes packTYPE)
+{
+	switch (packTYPE)
+	{
+	case packType_ResponseComplete:
+	case packType_ResponseTokenAt:
+	case packType_ResponseHDROnly:
+		return outPriority_High;
+	case packType_FullCyclicPartner:
+		return outPriority_Low;
+	default:
+		return outPriority_Normal;
+	}
+}
 void PolymorphicPacketPort::enQueueOutPacket(int packID, enum PacketTypes packTYPE, int packOPTION)
 {
-	if (packID > -1 && OutPackQueueDepth < PORTOUTPACK_BUFFERLENGTH)
+	enQueueOutPacket(packID, packTYPE, packOPTION, getDefaultOutPriority(packTYPE));
+}
+void PolymorphicPacketPort::enQueueOutPacket(int packID, enum PacketTypes packTYPE, int packOPTION, enum PacketOutPriority outPriority)
+{
+	if (packID > -1 && outPriority >= outPriority_High && outPriority <= outPriority_Low)
 	{
-		OutPacketQueue[OutPackQueueDepth].PackID = packID;
-		OutPacketQueue[OutPackQueueDepth].packTYPE = packTYPE;
-		OutPacketQueue[OutPackQueueDepth].packOPTION = packOPTION;
-		OutPackQueueDepth++;
+		struct OutPackQueueStruct outPack;
+		outPack.PackID = packID;
+		outPack.packTYPE = packTYPE;
+		outPack.packOPTION = packOPTION;
+
+		// a full lane drops the packet, or demotes it to the next lower lane
+		for (int i = outPriority; i < OutPackLaneCount; i++)
+		{
+			if (OutPacketLanes[i]->Push(&outPack))
+				return;
+			OutPacketLanes[i]->CountOverflow();
+			if (OutPacketLanes[i]->getOverflowPolicy() != outOverflow_Demote)
+				return;
+		}
 	}
 }
-void PolymorphicPacketPort::deQueueOutPacket()
+PacketOutQueue* PolymorphicPacketPort::SelectOutLane()
 {
-	for (int i = 1; i <= OutPackQueueDepth; i++)
+	// the packet peeked stays next until it is dequeued
+	if (OutLaneSelected > -1 && OutPacketLanes[OutLaneSelected]->Peek() != nullptr)
+		return OutPacketLanes[OutLaneSelected];
+	OutLaneSelected = -1;
+
+	if (OutScheduling == outSchedule_Weighted)
 	{
-		OutPacketQueue[i - 1].PackID = OutPacketQueue[i].PackID;
-		OutPacketQueue[i - 1].packTYPE = OutPacketQueue[i].packTYPE;
-		OutPacketQueue[i - 1].packOPTION = OutPacketQueue[i].packOPTION;
+		// highest lane with packets and credits left, a new round when none has credits left
+		for (int roundIndex = 0; roundIndex < 2; roundIndex++)
+		{
+			for (int i = 0; i < OutPackLaneCount; i++)
+			{
+				if (OutLaneCredits[i] > 0 && OutPacketLanes[i]->Peek() != nullptr)
+				{
+					OutLaneSelected = i;
+					return OutPacketLanes[i];
+				}
+			}
+			for (int i = 0; i < OutPackLaneCount; i++)
+				OutLaneCredits[i] = OutLaneWeights[i];
+		}
+		return nullptr;
+	}
+
+	for (int i = 0; i < OutPackLaneCount; i++)
+	{
+		if (OutPacketLanes[i]->Peek() != nullptr)
+		{
+			OutLaneSelected = i;
+			return OutPacketLanes[i];
+		}
 	}
-	if (OutPackQueueDepth > 0)
+	return nullptr;
+}
+void PolymorphicPacketPort::deQueueOutPacket()
+{
+	PacketOutQueue* outLanePtr = SelectOutLane();
+	if (outLanePtr != nullptr)
 	{
-		OutPacketQueue[OutPackQueueDepth].PackID = -1;
-		OutPackQueueDepth--;
+		outLanePtr->Pop();
+		if (OutScheduling == outSchedule_Weighted)
+			OutLaneCredits[OutLaneSelected]--;
+		OutLaneSelected = -1;
 	}
 }
 int PolymorphicPacketPort::getNextOutPackID()
 {
-	return OutPacketQueue[0].PackID;
+	PacketOutQueue* outLanePtr = SelectOutLane();
+	return (outLanePtr != nullptr) ? outLanePtr->Peek()->PackID : -1;
 }
 enum PacketTypes PolymorphicPacketPort::getNextOutPackType()
 {
-	return OutPacketQueue[0].packTYPE;
+	PacketOutQueue* outLanePtr = SelectOutLane();
+	return (outLanePtr != nullptr) ? outLanePtr->Peek()->packTYPE : packType_ReadComplete;
 }
 int PolymorphicPacketPort::getNextOutPackOption()
 {
-	return OutPacketQueue[0].packOPTION;
+	PacketOutQueue* outLanePtr = SelectOutLane();
+	return (outLanePtr != nullptr) ? outLanePtr->Peek()->packOPTION : 0;
 }
 int PolymorphicPacketPort::getOutPackQueueDepth()
 {
-	return OutPackQueueDepth;
+	int queueDepth = 0;
+	for (int i = 0; i < OutPackLaneCount; i++)
+		queueDepth += OutPacketLanes[i]->getDepth();
+	return queueDepth;
 }
 
-PolymorphicPacketPort::PolymorphicPacketPort(int PortIDin, PacketInterface* InputInterfaceIn, PacketInterface* OutputInterfaceIn, AbstractDataExecution* DataExecutionIn, bool isAsync)
+PolymorphicPacketPort::PolymorphicPacketPort(int PortIDin, PacketInterface* InputInterfaceIn, PacketInterface* OutputInterfaceIn, AbstractDataExecution* DataExecutionIn, bool isAsync) :
+	DefaultHighOutQueue(true), DefaultOutPacketQueue(true), DefaultLowOutQueue(true)	// handlers and application threads both enqueue
 {
 	InputInterface = InputInterfaceIn;
 	OutputInterface = OutputInterfaceIn;
 	DataExecution = DataExecutionIn;
 	ServiceAsync = isAsync;
 	PortID = PortIDin;
-	for (int i = 0; i < PORTOUTPACK_BUFFERLENGTH; i++)
-		OutPacketQueue[i].PackID = -1;
 }
 
 #pragma endregion
@@ -220,7 +483,21 @@ void	PacketPort_FileSystem::ServicePort()
 		break;
 	case fs_Reading:
 		InputInterface->ReadFrom();
-		if (InputInterface->DeSerializePacket()) {
+		if (isBatchRead)
+		{
+			// every packet framed is handled before the next read
+			bool isHandled = false;
+			while (InputInterface->DeSerializeFrame())
+			{
+				DataExecution->HandleRxPacket(this);
+				isHandled = true;
+			}
+			if (isHandled)
+				CyclesSinceReset = 0;
+			else if (++CyclesSinceReset > CyclestoReset)
+				ResetStateMachine();
+		}
+		else if (InputInterface->DeSerializePacket()) {
 			DataExecution->HandleRxPacket(this);
 
 			CyclesSinceReset = 0;
@@ -237,8 +514,12 @@ void	PacketPort_FileSystem::ServicePort()
 			if (OutputInterface->SerializePacket()) {
 				OutputInterface->WriteTo();
 			}
-			if (OutPackQueueDepth == 0)
+			// the written file is complete once the queue is drained
+			if (getOutPackQueueDepth() == 0)
+			{
+				OutputInterface->FlushTo();
 				ResetStateMachine();
+			}
 		}
 		else
 			break;
@@ -264,6 +545,14 @@ enum PacketPort_FS_State PacketPort_FileSystem::getFS_State()
 { 
 	return FS_State; 
 }
+void	PacketPort_FileSystem::setBatchRead(bool isBatchReadIn)
+{
+	isBatchRead = isBatchReadIn;
+}
+bool	PacketPort_FileSystem::getBatchRead()
+{
+	return isBatchRead;
+}
 #pragma endregion
 
 
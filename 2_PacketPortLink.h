@@ -6,6 +6,7 @@
 #ifndef __PACKETPORTLINK__
 #define __PACKETPORTLINK__
 #include "1_LanguageConstructs.h"
+#include "1_PacketView.h"
 
 
 
@@ -69,6 +70,83 @@ namespace IMSPacketsAPICore
 		FileSystem_Port
 	};
 
+	/*! \class PacketRxRing
+		\brief Receive ring buffer of a packet interface
+
+		Bytes read from a physical layer driver are staged in the ring, everything available
+		in one read, and are consumed by deserialization as the packet framing requires.  Partial
+		packets remain in the ring across service cycles, as do bytes following a complete packet.
+
+		Head and Tail are free running counts of bytes written and consumed, masked to the
+		ring size on access.
+	*/
+	class PacketRxRing
+	{
+		static_assert(PACKETINTERFACE_RXRINGSIZE > 0 && (PACKETINTERFACE_RXRINGSIZE & (PACKETINTERFACE_RXRINGSIZE - 1)) == 0, "receive ring size must be a power of 2");
+	private:
+		// slack after the ring keeps in place ID string compares, of a packet at the end of the ring, in the array
+		alignas(32) uint8_t	RingBytes[PACKETINTERFACE_RXRINGSIZE + STRINGBUFFER_IDTOKENRATIO];
+		uint32_t	Head = 0;
+		uint32_t	Tail = 0;
+
+		static constexpr uint32_t RingMask = PACKETINTERFACE_RXRINGSIZE - 1;
+
+	public:
+		inline int		getCount() { return (int)(Head - Tail); }
+		inline int		getSpace() { return PACKETINTERFACE_RXRINGSIZE - getCount(); }
+		inline bool		isEmpty() { return (Head == Tail); }
+		inline void		Clear() { Head = 0; Tail = 0; }
+
+		/*! \fn getWritePtr
+			\brief The first free byte, getContiguousSpace() bytes may be written there then committed
+
+			For drivers that read directly into the ring, e.g. a CustomReadFrom of a derived interface.
+		*/
+		inline uint8_t*	getWritePtr() { return &RingBytes[Head & RingMask]; }
+		inline int		getContiguousSpace()
+		{
+			int toEnd = PACKETINTERFACE_RXRINGSIZE - (int)(Head & RingMask);
+			return (getSpace() < toEnd) ? getSpace() : toEnd;
+		}
+		inline void		CommitWrite(int numBytes) { Head += (uint32_t)numBytes; }
+
+		/*! \fn getReadPtr
+			\brief The first unconsumed byte, getContiguousCount() bytes may be framed there in place then consumed
+
+			Consumed bytes are not overwritten until the next write to the ring.
+		*/
+		inline uint8_t*	getReadPtr() { return &RingBytes[Tail & RingMask]; }
+		inline int		getContiguousCount()
+		{
+			int toEnd = PACKETINTERFACE_RXRINGSIZE - (int)(Tail & RingMask);
+			return (getCount() < toEnd) ? getCount() : toEnd;
+		}
+		inline void		Consume(int numBytes) { Tail += (uint32_t)numBytes; }
+		/*! \fn Linearize
+			\brief Rotate the ring so every unconsumed byte is contiguous from getReadPtr()
+
+			For framing in place a packet that wraps the ring, at a cost of one pass over the ring.
+		*/
+		void			Linearize();
+
+		int				Write(const uint8_t* srcPtr, int numBytes);
+		int				Read(uint8_t* dstPtr, int numBytes);
+		/*! \fn FillFromStream
+			\brief Read all bytes available on a stream without blocking, up to the free space of the ring
+			\return The number of bytes read
+		*/
+		int				FillFromStream(std::istream* streamPtr);
+	};
+
+	/*! \struct PacketFrame
+		\brief A complete serialized packet found by batch framing, located in a framed byte range
+	*/
+	struct PacketFrame
+	{
+		int		Offset;
+		int		Length;
+	};
+
 	/*! \class PacketInterface
 		\brief An Abstraction of the serial interface connecting two api nodes
 
@@ -89,8 +167,10 @@ namespace IMSPacketsAPICore
 
 		int					serializedPacketSize	= 0;
 		int					tokenIndex				= 0;
+		PacketRxRing		RxRing;					// filled by ReadFrom, consumed by DeSerializePacket
 		virtual void		CustomWriteTo() { ; }
 		virtual void		CustomReadFrom() { ; }
+		virtual void		CustomFlushTo() { ; }
 		virtual void		WriteToStream()			= 0;
 		virtual void		ReadFromStream()		= 0;
 
@@ -128,6 +208,33 @@ namespace IMSPacketsAPICore
 			Packets in a packet buffer
 		*/
 		void				ReadFrom();
+
+		//! Write any output staged by the interface or its stream now
+		void				FlushTo();
+
+		/*! \fn DeSerializeFrame
+			\brief Batch deserialization, a packet at a time, for ports handling every packet read at once
+
+			Places the next complete packet of the receive ring in the interface packet, framing the ring
+			PACKETINTERFACE_FRAMECOUNT packets at a time, then completes packets partially assembled or
+			wrapping the ring as DeSerializePacket does.  Framed packets are in place in consumed ring bytes,
+			so it is called until false before the next ReadFrom, or SerializePacket of the same interface.
+			Interfaces without batch framing deserialize one packet.
+		*/
+		virtual bool		DeSerializeFrame()	{ return DeSerializePacket(); }
+
+		/*! \fn getEventFD
+			\brief The file descriptor of an interface backed by one, for event driven service, -1 otherwise
+		*/
+		virtual int			getEventFD()		{ return -1; }
+		//! Output partially written, waiting for the descriptor of the interface to be writable
+		virtual bool		isOutputBlocked()	{ return false; }
+		//! Microseconds until staged output must be written, 0 if overdue, -1 if none is staged with a deadline
+		virtual int			getOutputDeadlineMicros()	{ return -1; }
+		//! The input of an interface backed by a descriptor has reached end of file
+		virtual bool		isInputClosed()		{ return false; }
+		//! Bytes read into the receive ring and not yet consumed by deserialization
+		inline bool			isInputPending()	{ return !RxRing.isEmpty(); }
 		
 	};
 
@@ -172,6 +279,28 @@ namespace IMSPacketsAPICore
 		virtual void				Loop() = 0;
 	};
 
+	/*! \brief Priority Lanes of the Packet Port Output Queue, highest first */
+	enum PacketOutPriority
+	{
+		outPriority_High,
+		outPriority_Normal,
+		outPriority_Low
+	};
+
+	/*! \brief Scheduling of Packet Port Output between Priority Lanes */
+	enum PacketOutScheduling
+	{
+		outSchedule_Strict,		// the highest priority lane with a packet is always next
+		outSchedule_Weighted	// lanes with packets take turns, each dequeuing up to its weight per round
+	};
+
+	/*! \brief What a Packet Port does with a Packet Enqueued to a Full Lane */
+	enum PacketOutOverflow
+	{
+		outOverflow_Drop,		// the packet is dropped and counted
+		outOverflow_Demote		// the packet is enqueued to the next lower priority lane, dropped if none has room
+	};
+
 	struct OutPackQueueStruct
 	{
 		int PackID = -1;
@@ -179,6 +308,93 @@ namespace IMSPacketsAPICore
 		int packOPTION = 0;
 	};
 
+	/*! \class PacketOutQueue
+		\brief Fixed capacity lock-free ring of packets queued for output by a packet port
+
+		One consumer, the thread servicing the port, peeks and pops the next packet.  Producers
+		enqueue from any thread, one at a time by default, or concurrently when the queue is
+		multi-producer.  Each slot carries a sequence count, so a consumer never reads a slot
+		before its producer has published it, and a producer never overwrites a slot before
+		the consumer has popped it.
+
+		Head and Tail are free running counts of packets popped and claimed, masked to the
+		capacity on access.  The slots are storage of the derived PacketOutQueueSized.
+
+		A coalescing queue merges a packet with an identical one (ID, type, and option) still waiting
+		to be peeked, so a packet requested repeatedly before the port drains is sent once, packaged
+		with the newest state.  A direct mapped index of the packet hash to the slot last enqueued with
+		it finds the identical packet in O(1).  Packets sharing an index entry are simply not merged,
+		nor are packets with IDs beyond 2^28 - 2.
+	*/
+	class PacketOutQueue
+	{
+	protected:
+		struct OutPackQueueSlot
+		{
+			std::atomic<uint32_t>		Sequence;
+			std::atomic<uint64_t>		CoalesceKey;	// of the entry until it is peeked, 0 otherwise
+			struct OutPackQueueStruct	Entry;
+		};
+
+		OutPackQueueSlot*		SlotsPtr;
+		std::atomic<uint32_t>*	CoalesceIndexPtr;	// slot index + 1, 0 if none
+		const uint32_t			CapacityMask;
+		const bool				isMultiProducer;
+		bool					isCoalescing		= false;
+		enum PacketOutOverflow	OverflowPolicy		= outOverflow_Drop;
+		std::atomic<uint32_t>	OverflowCount;
+		std::atomic<uint32_t>	CoalescedCount;
+		alignas(64) std::atomic<uint32_t>	Tail;		// producers
+		alignas(64) std::atomic<uint32_t>	Head;		// consumer
+
+		static uint64_t	getCoalesceKey(const struct OutPackQueueStruct* EntryPtr);
+		void			ClearCoalesceKey(OutPackQueueSlot* slotPtr);
+
+		PacketOutQueue(OutPackQueueSlot* SlotsPtrIn, std::atomic<uint32_t>* CoalesceIndexPtrIn, int CapacityIn, bool isMultiProducerIn);
+
+	public:
+		//! Enqueue a packet, or merge it with an identical packet waiting when coalescing, false if the queue is full
+		bool	Push(const struct OutPackQueueStruct* EntryPtr);
+		/*! \fn Peek
+			\brief The next packet, valid until it is popped, or nullptr if the queue is empty
+		*/
+		const struct OutPackQueueStruct*	Peek();
+		void	Pop();
+
+		//! Packets claimed by producers and not yet popped, exact when called by the consumer of a single producer queue
+		int		getDepth();
+		inline int	getCapacity() { return (int)CapacityMask + 1; }
+		inline bool	getMultiProducer() { return isMultiProducer; }
+
+		//! Policy of a packet port enqueuing to this queue as one of its lanes when it is full
+		inline void	setOverflowPolicy(enum PacketOutOverflow OverflowPolicyIn) { OverflowPolicy = OverflowPolicyIn; }
+		inline enum PacketOutOverflow	getOverflowPolicy() { return OverflowPolicy; }
+		//! Packets dropped by a packet port, or demoted to a lower lane, because this queue was full
+		inline int	getOverflowCount() { return (int)OverflowCount.load(std::memory_order_relaxed); }
+		inline void	CountOverflow() { OverflowCount.fetch_add(1, std::memory_order_relaxed); }
+
+		//! Merge identical waiting packets, set before packets are enqueued
+		inline void	setCoalescing(bool isCoalescingIn) { isCoalescing = isCoalescingIn; }
+		inline bool	getCoalescing() { return isCoalescing; }
+		//! Packets merged with an identical waiting packet
+		inline int	getCoalescedCount() { return (int)CoalescedCount.load(std::memory_order_relaxed); }
+	};
+
+	/*! \class PacketOutQueueSized
+		\brief Packet output queue of QueueCapacity slots, a power of 2, and a coalescing index of twice as many entries
+	*/
+	template<int QueueCapacity>
+	class PacketOutQueueSized : public PacketOutQueue
+	{
+		static_assert(QueueCapacity > 0 && (QueueCapacity & (QueueCapacity - 1)) == 0, "out packet queue capacity must be a power of 2");
+	protected:
+		OutPackQueueSlot		Slots[QueueCapacity];
+		std::atomic<uint32_t>	CoalesceIndex[2 * QueueCapacity];
+	public:
+		PacketOutQueueSized(bool isMultiProducerIn = false, bool isCoalescingIn = false) :
+			PacketOutQueue(&Slots[0], &CoalesceIndex[0], QueueCapacity, isMultiProducerIn) { setCoalescing(isCoalescingIn); }
+	};
+
 	/*! \class PolymorphicPacketPort
 		\brief An Abstraction of the Distributed Node Link
 
@@ -193,14 +409,24 @@ namespace IMSPacketsAPICore
 	class PolymorphicPacketPort
 	{
 	protected:
-		int								OutPackQueueDepth	= 0;
 		int								PortID				= 0;
 		enum PacketPortPartnerType		PortType			= SenderResponder_Responder;
 		PacketInterface*				InputInterface		= nullptr;
 		PacketInterface*				OutputInterface		= nullptr;
 		AbstractDataExecution*			DataExecution		= nullptr;
 		bool							ServiceAsync		= false;
-		struct OutPackQueueStruct		OutPacketQueue[PORTOUTPACK_BUFFERLENGTH];
+		static constexpr int			OutPackLaneCount	= outPriority_Low + 1;
+		PacketOutQueueSized<PORTOUTPACK_LANELENGTH>		DefaultHighOutQueue;
+		PacketOutQueueSized<PORTOUTPACK_BUFFERLENGTH>	DefaultOutPacketQueue;
+		PacketOutQueueSized<PORTOUTPACK_LANELENGTH>		DefaultLowOutQueue;
+		PacketOutQueue*					OutPacketLanes[OutPackLaneCount] = { &DefaultHighOutQueue, &DefaultOutPacketQueue, &DefaultLowOutQueue };
+
+		// consumer state, the lane of the packet peeked until it is dequeued, and weighted round credits
+		enum PacketOutScheduling		OutScheduling		= outSchedule_Strict;
+		int								OutLaneWeights[OutPackLaneCount] = { 4, 2, 1 };
+		int								OutLaneCredits[OutPackLaneCount] = { 0, 0, 0 };
+		int								OutLaneSelected		= -1;
+		PacketOutQueue*					SelectOutLane();
 
 	public:
 		PacketInterface* getInputInterface();
@@ -211,12 +437,41 @@ namespace IMSPacketsAPICore
 
 		virtual bool	isSupportedInPackType(enum PacketTypes packTYPE) = 0;
 
+		/*! \fn setOutPacketQueue
+			\brief Replace the default output queue of a priority lane, e.g. with a deeper or coalescing queue
+
+			The default queues hold PORTOUTPACK_BUFFERLENGTH normal priority packets, and PORTOUTPACK_LANELENGTH
+			packets of each other priority.  They are multi-producer, so handlers on the thread servicing the port
+			and application threads may enqueue concurrently.  A replacement queue is single-producer only when
+			one thread enqueues to its lane.  The depth, overflow policy, and coalescing of a lane are those of its queue.
+			Set before the port is serviced and packets are enqueued, packets of the replaced queue are not moved.
+		*/
+		void	setOutPacketQueue(PacketOutQueue* OutPacketQueueIn, enum PacketOutPriority outPriority = outPriority_Normal);
+		PacketOutQueue*	getOutPacketQueue(enum PacketOutPriority outPriority = outPriority_Normal);
+
+		/*! \fn setOutScheduling
+			\brief Configure how the next packet is chosen between priority lanes
+
+			Strict by default.  Weighted scheduling dequeues up to the weight of each lane with packets per
+			round, highest priority first, so low priority packets are delayed but never starved.
+		*/
+		void	setOutScheduling(enum PacketOutScheduling outScheduling, int highWeight = 4, int normalWeight = 2, int lowWeight = 1);
+		enum PacketOutScheduling	getOutScheduling();
+
+		//! The default lane of a packet type, responses are high priority and full cyclic partner packets low
+		static enum PacketOutPriority	getDefaultOutPriority(enum PacketTypes packTYPE);
+
+		//! Enqueue a packet for output in the default lane of its type, from any thread when its lane is multi-producer
 		void	enQueueOutPacket(int packID, enum PacketTypes packTYPE, int packOPTION = 0);
+		//! Enqueue a packet for output in a lane
+		void	enQueueOutPacket(int packID, enum PacketTypes packTYPE, int packOPTION, enum PacketOutPriority outPriority);
 		void	deQueueOutPacket();
 
+		//! -1 if the queue is empty
 		int		getNextOutPackID();
 		enum	PacketTypes getNextOutPackType();
 		int		getNextOutPackOption();
+		//! Packets queued in all lanes
 		int		getOutPackQueueDepth();
 
 		virtual void	ResetStateMachine() = 0;
@@ -267,6 +522,7 @@ namespace IMSPacketsAPICore
 		enum PacketPort_FS_State FS_State = fs_Init;
 		const int CyclestoReset = STRINGBUFFER_CHARCOUNT;
 		int CyclesSinceReset = 0;
+		bool isBatchRead = false;
 	public:
 		PacketPort_FileSystem(int PortIDin, PacketInterface* InputInterfaceIn, PacketInterface* OutputInterfaceIn, AbstractDataExecution* DataExecutionIn, bool isAsync = false);
 		void	ServicePort();
@@ -275,6 +531,10 @@ namespace IMSPacketsAPICore
 		void	SetStateMachineRead();
 		void	SetStateMachineWrite();
 		enum PacketPort_FS_State getFS_State();
+
+		//! Handle every packet read in a service, by DeSerializeFrame, rather than one packet per service
+		void	setBatchRead(bool isBatchReadIn);
+		bool	getBatchRead();
 	};
 	/*! @}*/
 }
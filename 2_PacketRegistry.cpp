@@ -0,0 +1,171 @@
+#include "2_PacketRegistry.h"
+using namespace IMSPacketsAPICore;
+
+
+#pragma region PacketRegistryBase Implementation
+
+// displacements of buckets already placed are marked while the slots are built
+#define PACKETREGISTRY_PLACEDMARK (0x80000000u)
+#define PACKETREGISTRY_MAXDISPLACEMENT (0x00100000u)
+
+PacketRegistryBase::PacketRegistryBase(struct PacketRegistryEntry* EntriesIn, int IDCapacityIn, int* StringSlotsIn, uint32_t* StringDisplacementsIn, int StringSlotCountIn)
+{
+	Entries = EntriesIn;
+	IDCapacity = IDCapacityIn;
+	StringSlots = StringSlotsIn;
+	StringDisplacements = StringDisplacementsIn;
+	StringSlotCount = StringSlotCountIn;
+}
+
+// place every registered ID string, largest buckets first, searching a displacement per bucket
+bool PacketRegistryBase::BuildStringSlots()
+{
+	uint32_t bucketMask = StringBucketCount() - 1;
+	uint32_t slotMask = StringSlotCount - 1;
+	int maxBucketSize = 0;
+
+	for (int i = 0; i < StringSlotCount; i++)
+		StringSlots[i] = -1;
+	for (int b = 0; b < StringBucketCount(); b++)
+		StringDisplacements[b] = 0;
+	for (int i = 0; i < IDCapacity; i++)
+	{
+		if (Entries[i].PacketPtr != nullptr)
+		{
+			uint32_t b = StringSlotHash(Entries[i].IDStringHash, 0) & bucketMask;
+			if ((int)(++StringDisplacements[b]) > maxBucketSize)
+				maxBucketSize = StringDisplacements[b];
+		}
+	}
+
+	for (int bucketSize = maxBucketSize; bucketSize > 0; bucketSize--)
+	{
+		for (uint32_t b = 0; b <= bucketMask; b++)
+		{
+			if (StringDisplacements[b] != (uint32_t)bucketSize)
+				continue;
+
+			uint32_t d;
+			for (d = 1; d < PACKETREGISTRY_MAXDISPLACEMENT; d++)
+			{
+				// occupy the slots of each member, roll back on the first collision
+				bool isPlaced = true;
+				for (int i = 0; i < IDCapacity && isPlaced; i++)
+				{
+					if (Entries[i].PacketPtr == nullptr || (StringSlotHash(Entries[i].IDStringHash, 0) & bucketMask) != b)
+						continue;
+					uint32_t slot = StringSlotHash(Entries[i].IDStringHash, d) & slotMask;
+					if (StringSlots[slot] == -1)
+						StringSlots[slot] = i;
+					else
+						isPlaced = false;
+				}
+				if (isPlaced)
+					break;
+				for (int i = 0; i < IDCapacity; i++)
+				{
+					if (Entries[i].PacketPtr == nullptr || (StringSlotHash(Entries[i].IDStringHash, 0) & bucketMask) != b)
+						continue;
+					uint32_t slot = StringSlotHash(Entries[i].IDStringHash, d) & slotMask;
+					if (StringSlots[slot] == i)
+						StringSlots[slot] = -1;
+				}
+			}
+			if (d == PACKETREGISTRY_MAXDISPLACEMENT)
+				return false;
+			StringDisplacements[b] = d | PACKETREGISTRY_PLACEDMARK;
+		}
+	}
+
+	for (int b = 0; b < StringBucketCount(); b++)
+		StringDisplacements[b] &= ~PACKETREGISTRY_PLACEDMARK;
+	return true;
+}
+
+bool PacketRegistryBase::RegisterPacket(Packet* PacketPtrIn, PacketHandlerFunction HandlerIn, void* HandlerContextIn)
+{
+	if (PacketPtrIn == nullptr)
+		return false;
+	int packID = PacketPtrIn->getPacketID();
+	if (packID < 0 || packID >= IDCapacity || Entries[packID].PacketPtr != nullptr)
+		return false;
+
+	// two ID strings of one hash can not be told apart by the string slots
+	uint32_t idStringHash = PacketPtrIn->getPacketIDStringHash();
+	for (int i = 0; i < IDCapacity; i++)
+		if (Entries[i].PacketPtr != nullptr && Entries[i].IDStringHash == idStringHash)
+			return false;
+
+	Entries[packID].PacketID = packID;
+	Entries[packID].IDStringHash = idStringHash;
+	Entries[packID].PacketPtr = PacketPtrIn;
+	Entries[packID].Handler = HandlerIn;
+	Entries[packID].HandlerContext = HandlerContextIn;
+	NumRegistered++;
+
+	if (!BuildStringSlots())
+	{
+		Entries[packID] = PacketRegistryEntry();
+		NumRegistered--;
+		BuildStringSlots();
+		return false;
+	}
+	return true;
+}
+
+struct PacketRegistryEntry* PacketRegistryBase::LookupID(int packID)
+{
+	if (packID < 0 || packID >= IDCapacity || Entries[packID].PacketPtr == nullptr)
+		return nullptr;
+	return &Entries[packID];
+}
+
+struct PacketRegistryEntry* PacketRegistryBase::LookupIDString(const char* idStringPtr)
+{
+	if (idStringPtr == nullptr || NumRegistered == 0)
+		return nullptr;
+
+	uint32_t idStringHash = Packet::IDStringHash(idStringPtr);
+	uint32_t d = StringDisplacements[StringSlotHash(idStringHash, 0) & (StringBucketCount() - 1)];
+	if (d == 0)
+		return nullptr;
+	int packID = StringSlots[StringSlotHash(idStringHash, d) & (StringSlotCount - 1)];
+	if (packID < 0 || Entries[packID].IDStringHash != idStringHash)
+		return nullptr;
+
+	if (!Packet::IDStringSlot_Equals(idStringPtr, Entries[packID].PacketPtr->getPacketIDString(), Entries[packID].PacketPtr->getPacketIDStringLength()))
+		return nullptr;
+	return &Entries[packID];
+}
+
+struct PacketRegistryEntry* PacketRegistryBase::LookupPacket(Packet* rxPacketPtr)
+{
+	if (rxPacketPtr == nullptr)
+		return nullptr;
+	if (rxPacketPtr->isASCIIPacket())
+		return LookupIDString(rxPacketPtr->getCharsBuffer());
+	return LookupID(rxPacketPtr->ByteBuffer_ID());
+}
+
+bool PacketRegistryBase::DispatchPacket(PacketInterface* rxInterfacePtr)
+{
+	if (rxInterfacePtr == nullptr)
+		return false;
+	return DispatchPacket(rxInterfacePtr->getPacketPtr(), rxInterfacePtr->getPacketType());
+}
+
+bool PacketRegistryBase::DispatchPacket(Packet* rxPacketPtr, enum PacketTypes PackType)
+{
+	struct PacketRegistryEntry* entryPtr = LookupPacket(rxPacketPtr);
+	if (entryPtr == nullptr || entryPtr->Handler == nullptr)
+		return false;
+
+	entryPtr->PacketPtr->CopyTokenBufferPtrs(rxPacketPtr);
+	entryPtr->Handler(entryPtr->PacketPtr, PackType, entryPtr->HandlerContext);
+	return true;
+}
+
+int PacketRegistryBase::getIDCapacity() { return IDCapacity; }
+int PacketRegistryBase::getNumRegistered() { return NumRegistered; }
+
+#pragma endregion
@@ -0,0 +1,129 @@
+/*! \file  2_PacketRegistry.h
+	\brief Constant Time Packet ID Dispatch
+
+*/
+
+#ifndef __PACKETREGISTRY__
+#define __PACKETREGISTRY__
+#include "2_PacketPortLink.h"
+
+
+
+namespace IMSPacketsAPICore
+{
+	/*! \addtogroup PacketPortLink
+		@{
+	*/
+
+	/*! \brief Handler called by a packet registry on receipt of a registered packet
+
+		PacketPtr is the registered packet instance, bound to the token buffers of the
+		receiving interface.  HandlerContext is the pointer given at registration.
+	*/
+	typedef void (*PacketHandlerFunction)(Packet* PacketPtr, enum PacketTypes PackType, void* HandlerContext);
+
+	/*! \struct PacketRegistryEntry
+		\brief A registered packet class and its receive handler
+	*/
+	struct PacketRegistryEntry
+	{
+		int						PacketID		= -1;
+		uint32_t				IDStringHash	= 0;
+		Packet*					PacketPtr		= nullptr;
+		PacketHandlerFunction	Handler			= nullptr;
+		void*					HandlerContext	= nullptr;
+	};
+
+	/*! \class PacketRegistryBase
+		\brief Maps received packet IDs to packet classes and handlers in constant time
+
+		Binary packet IDs index a dense table of entries.  ASCII ID strings are hashed once
+		(Packet::IDStringHash) and placed by a two level perfect hash: the hash selects a
+		bucket, and the displacement of that bucket selects a slot no other registered ID
+		string occupies.  Displacements are searched when a packet is registered, so a lookup
+		is one hash of the received ID string, two table reads, and one string compare.
+
+		The tables are allocated by PacketRegistrySized, so a single implementation serves
+		registries of every capacity.
+	*/
+	class PacketRegistryBase
+	{
+	protected:
+		struct PacketRegistryEntry*	Entries;			// IDCapacity entries, indexed by packet ID
+		int							IDCapacity;
+		int*						StringSlots;		// StringSlotCount packet IDs, -1 if empty
+		uint32_t*					StringDisplacements;// StringSlotCount/2 bucket displacements
+		int							StringSlotCount;	// power of 2, at least 2*IDCapacity
+		int							NumRegistered = 0;
+
+		static inline uint32_t	StringSlotHash(uint32_t idStringHash, uint32_t displacement)
+		{
+			uint32_t hashVal = idStringHash ^ (displacement * 0x9E3779B9u);
+			hashVal ^= hashVal >> 16;
+			hashVal *= 0x85EBCA6Bu;
+			hashVal ^= hashVal >> 13;
+			hashVal *= 0xC2B2AE35u;
+			hashVal ^= hashVal >> 16;
+			return hashVal;
+		}
+		inline int				StringBucketCount() { return StringSlotCount / 2; }
+		bool					BuildStringSlots();
+
+		PacketRegistryBase(struct PacketRegistryEntry* EntriesIn, int IDCapacityIn, int* StringSlotsIn, uint32_t* StringDisplacementsIn, int StringSlotCountIn);
+
+	public:
+		/*! \fn RegisterPacket
+			\brief Register a packet class instance and its receive handler
+			\return True if registered, False if the ID is out of range, taken, or its ID string collides
+
+			The packet instance is kept by the registry, its token buffers are rebound to the
+			receiving interface at each dispatch.
+		*/
+		bool							RegisterPacket(Packet* PacketPtrIn, PacketHandlerFunction HandlerIn, void* HandlerContextIn = nullptr);
+		struct PacketRegistryEntry*		LookupID(int packID);
+		/*! \fn LookupIDString
+			\brief Find the registered packet of an ID string token slot of STRINGBUFFER_IDTOKENRATIO chars
+		*/
+		struct PacketRegistryEntry*		LookupIDString(const char* idStringPtr);
+		struct PacketRegistryEntry*		LookupPacket(Packet* rxPacketPtr);
+
+		/*! \fn DispatchPacket
+			\brief Call the registered handler of the packet in an interface buffer
+			\return True if the packet is registered and handled, False otherwise
+		*/
+		bool							DispatchPacket(PacketInterface* rxInterfacePtr);
+		/*! \fn DispatchPacket
+			\brief Call the registered handler of a received packet, bound to any token buffer (e.g. a batch frame)
+		*/
+		bool							DispatchPacket(Packet* rxPacketPtr, enum PacketTypes PackType);
+		int								getIDCapacity();
+		int								getNumRegistered();
+	};
+
+	/*! \class PacketRegistrySized
+		\brief A packet registry with tables for packet IDs 0 through RegistryIDCapacity-1
+	*/
+	template<int RegistryIDCapacity = PACKETREGISTRY_IDCAPACITY>
+	class PacketRegistrySized : public PacketRegistryBase
+	{
+		static_assert(RegistryIDCapacity > 0, "registries map at least one packet ID");
+		static constexpr int StringSlotCountOf(int slotCount) { return (slotCount >= 2 * RegistryIDCapacity) ? slotCount : StringSlotCountOf(2 * slotCount); }
+	protected:
+		struct PacketRegistryEntry	EntryTable[RegistryIDCapacity];
+		int							StringSlotTable[StringSlotCountOf(2)];
+		uint32_t					StringDisplacementTable[StringSlotCountOf(2) / 2];
+
+	public:
+		PacketRegistrySized() :
+			PacketRegistryBase(&EntryTable[0], RegistryIDCapacity, &StringSlotTable[0], &StringDisplacementTable[0], StringSlotCountOf(2)) { ; }
+	};
+
+	/*! \class PacketRegistry
+		\brief A packet registry of the default ID capacity
+	*/
+	typedef PacketRegistrySized<PACKETREGISTRY_IDCAPACITY> PacketRegistry;
+
+	/*! @}*/
+}
+
+#endif // !__PACKETREGISTRY__
@@ -1,15 +1,15 @@
 #include "3_APINodeLink.h"
 using namespace IMSPacketsAPICore;
 
-#pragma region PacketInterface_Binary<TokenType>  Implementation
+#pragma region PacketInterface_Binary<TokenType, TokenCapacity>  Implementation
 //template class PacketInterface_Binary<SPD1>;
 //template class PacketInterface_Binary<SPD2>;
 //template class PacketInterface_Binary<SPD4>;
 //template class PacketInterface_Binary<SPD8>;
 
 
-template<class TokenType>
-void PacketInterface_Binary<TokenType>::WriteToStream()
+template<class TokenType, int TokenCapacity>
+void PacketInterface_Binary<TokenType, TokenCapacity>::WriteToStream()
 {
 	if (ifaceStreamPtr != nullptr)
 		ifaceStreamPtr->write((char*)(&(TokenBuffer.bytes[0])), serializedPacketSize);
@@ -17,137 +17,341 @@ void PacketInterface_Binary<TokenType>::WriteToStream()
 		ifaceOutStreamPtr->write((char*)(&(TokenBuffer.bytes[0])), serializedPacketSize);
 }
 
-template<class TokenType>
-void PacketInterface_Binary<TokenType>::ReadFromStream()
+template<class TokenType, int TokenCapacity>
+void PacketInterface_Binary<TokenType, TokenCapacity>::ReadFromStream()
 {
 	if (ifaceStreamPtr != nullptr)
-	{
-		if (ifaceStreamPtr->peek() != EOF)
-			ifaceStreamPtr->read((char*)(&(TokenBuffer.bytes[ByteIndex++])), 1);
-	}
+		RxRing.FillFromStream(ifaceStreamPtr);
 	else if (ifaceInStreamPtr != nullptr)
-	{
-		if (ifaceInStreamPtr->peek() != EOF)
-			ifaceInStreamPtr->read((char*)(&(TokenBuffer.bytes[ByteIndex++])), 1);
-	}
+		RxRing.FillFromStream(ifaceInStreamPtr);
 }
 
-template<class TokenType>
-void PacketInterface_Binary<TokenType>::ResetdeSerialize()
+template<class TokenType, int TokenCapacity>
+void PacketInterface_Binary<TokenType, TokenCapacity>::ResetdeSerialize()
 {
 	ByteIndex = 0;
-	ByteIndexLast = 0;
 	deSerializedPacketSize = 0;
 	deSerializedTokenIndex = 0;
 	deSerializedTokenLength.uintVal = 0;
 	deSerializeReset = false;
 }
 
-template<class TokenType>
-bool PacketInterface_Binary<TokenType>::DeSerializePacket_Binary(PacketInterface_Binary<TokenType>* PcktInterface)
+template<class TokenType, int TokenCapacity>
+bool PacketInterface_Binary<TokenType, TokenCapacity>::DeSerializePacket_Binary(PacketInterface_Binary<TokenType, TokenCapacity>* PcktInterface)
 {
 	// called cyclically
-	// monitor ByteIndex for change
-	if (PcktInterface->ByteIndex != PcktInterface->ByteIndexLast)
+	// consume the receive ring token by token, until a packet is complete or the ring is empty
+	while (!PcktInterface->RxRing.isEmpty())
 	{
-		// monitor byte array for token boundary
-		if ((PcktInterface->ByteIndex % PcktInterface->getTokenSize()) == 0)
+		// read up to the next token boundary, never beyond the token buffer
+		int tokenBytes = PcktInterface->getTokenSize() - (PcktInterface->ByteIndex % PcktInterface->getTokenSize());
+		if (PcktInterface->ByteIndex + tokenBytes > (int)sizeof(PcktInterface->TokenBuffer.bytes))
+		{
+			PcktInterface->ResetdeSerialize();
+			continue;
+		}
+		PcktInterface->ByteIndex += PcktInterface->RxRing.Read(&PcktInterface->TokenBuffer.bytes[PcktInterface->ByteIndex], tokenBytes);
+
+		// a partial token waits for the next chunk
+		if ((PcktInterface->ByteIndex % PcktInterface->getTokenSize()) != 0)
+			break;
+
+		// if its the length token index, read it in host byte order
+		if (PcktInterface->deSerializedTokenIndex == Index_PackLEN)
 		{
-			// optionally and conditionally swap byte order of tokens here
-			;
+			PcktInterface->BufferPacket.readbuff_PackLength(&PcktInterface->deSerializedTokenLength);
+			if (PcktInterface->isWireByteOrderSwapped())
+				Packet::swapTokenByteOrder((uint8_t*)&PcktInterface->deSerializedTokenLength, 1, sizeof(TokenType));
 
 			// decide if error, trigger reset
-			PcktInterface->deSerializeReset = false;// TODO:
+			// lengths shorter than a header, beyond the token buffer, or of partial tokens
+			if (PcktInterface->deSerializedTokenLength.uintVal < Packet_HDRPACK::TokenCount * sizeof(TokenType)
+				|| PcktInterface->deSerializedTokenLength.uintVal > PacketBytesCapacity
+				|| (PcktInterface->deSerializedTokenLength.uintVal % sizeof(TokenType)) != 0)
+				PcktInterface->deSerializeReset = true;
+		}
 
-			// if its the length token index
-			if (PcktInterface->deSerializedTokenIndex == Index_PackLEN)
-				PcktInterface->BufferPacket.readbuff_PackLength(&PcktInterface->deSerializedTokenLength);
-			
-			// decide if complete packet
-			// return true or false
-			// true will trigger the rx packet handler of the data execution instance
-			if (PcktInterface->ByteIndex == PcktInterface->deSerializedTokenLength.uintVal)
+		// reset if triggered, framing restarts at the next byte in the ring
+		if (PcktInterface->deSerializeReset)
+		{
+			PcktInterface->ResetdeSerialize();
+			continue;
+		}
+
+		// decide if complete packet, and its trailer when frame checked
+		// return true or false
+		// true will trigger the rx packet handler of the data execution instance
+		if (PcktInterface->ByteIndex > Index_PackLEN * (int)sizeof(TokenType)
+			&& PcktInterface->ByteIndex == (int)PcktInterface->deSerializedTokenLength.uintVal + (PcktInterface->FrameChecked ? FrameCheckBytes : 0))
+		{
+			// reject a packet failing its frame check, framing restarts after its trailer
+			if (PcktInterface->FrameChecked && !isFrameCheckValid(&PcktInterface->TokenBuffer.bytes[0], (int)PcktInterface->deSerializedTokenLength.uintVal))
 			{
+				PcktInterface->FrameCheckErrors++;
 				PcktInterface->ResetdeSerialize();
-				return true;
+				continue;
 			}
-			PcktInterface->deSerializedTokenIndex++;
+
+			// conditionally swap byte order of all tokens, in one pass
+			if (PcktInterface->isWireByteOrderSwapped())
+				Packet::swapTokenByteOrder(&PcktInterface->TokenBuffer.bytes[0], (int)PcktInterface->deSerializedTokenLength.uintVal / sizeof(TokenType), sizeof(TokenType));
+			PcktInterface->ResetdeSerialize();
+			return true;
 		}
+		PcktInterface->deSerializedTokenIndex++;
 	}
+	return false;
+}
 
+template<class TokenType, int TokenCapacity>
+int PacketInterface_Binary<TokenType, TokenCapacity>::FramePackets_Binary(PacketInterface_Binary<TokenType, TokenCapacity>* PcktInterface, uint8_t* bytesPtr, int numBytes, struct PacketFrame* framesPtr, int maxFrames, int* numBytesFramedPtr)
+{
+	// called single-shot over a whole range
+	// step from length token to length token, until the range or the frames run out
+	int numFrames = 0;
+	int byteOffset = 0;
+	const int headerBytes = (Index_PackLEN + 1) * sizeof(TokenType);
+	TokenType frameTokenLength;
+
+	while (numFrames < maxFrames && numBytes - byteOffset >= headerBytes)
+	{
+		memcpy(&frameTokenLength, bytesPtr + byteOffset + Index_PackLEN * sizeof(TokenType), sizeof(TokenType));
+		if (PcktInterface->isWireByteOrderSwapped())
+			Packet::swapTokenByteOrder((uint8_t*)&frameTokenLength, 1, sizeof(TokenType));
+
+		// decide if error, skip the header tokens read
+		// lengths shorter than a header, beyond the token buffer, or of partial tokens
+		if (frameTokenLength.uintVal < Packet_HDRPACK::TokenCount * sizeof(TokenType)
+			|| frameTokenLength.uintVal > PacketBytesCapacity
+			|| (frameTokenLength.uintVal % sizeof(TokenType)) != 0)
+		{
+			byteOffset += headerBytes;
+			continue;
+		}
 
+		// a partial packet, or trailer, waits for more bytes
+		int frameLength = (int)frameTokenLength.uintVal;
+		int trailerBytes = PcktInterface->FrameChecked ? FrameCheckBytes : 0;
+		if (frameLength + trailerBytes > numBytes - byteOffset)
+			break;
 
-	// Reset if triggerred
-	if (PcktInterface->deSerializeReset)
-	{
-		PcktInterface->ResetdeSerialize();
+		// a packet failing its frame check is skipped as a bad length is
+		if (PcktInterface->FrameChecked && !isFrameCheckValid(bytesPtr + byteOffset, frameLength))
+		{
+			PcktInterface->FrameCheckErrors++;
+			byteOffset += headerBytes;
+			continue;
+		}
+
+		// conditionally swap byte order of all tokens, in one pass, in place
+		if (PcktInterface->isWireByteOrderSwapped())
+			Packet::swapTokenByteOrder(bytesPtr + byteOffset, frameLength / sizeof(TokenType), sizeof(TokenType));
+		framesPtr[numFrames].Offset = byteOffset;
+		framesPtr[numFrames].Length = frameLength;
+		numFrames++;
+		byteOffset += frameLength + trailerBytes;
 	}
 
-	// Capture history for change detect
-	PcktInterface->ByteIndexLast = PcktInterface->ByteIndex;
-	return false;
+	*numBytesFramedPtr = byteOffset;
+	return numFrames;
 }
 
-template<class TokenType>
-bool PacketInterface_Binary<TokenType>::SerializePacket_Binary(PacketInterface_Binary<TokenType>* PcktInterface)
+template<class TokenType, int TokenCapacity>
+bool PacketInterface_Binary<TokenType, TokenCapacity>::SerializePacket_Binary(PacketInterface_Binary<TokenType, TokenCapacity>* PcktInterface)
 {
 	// called single-shot after tx packet handler of the data execution instance
-		// optionally swap bytes order before sending
-	;
+	// the packet length token sizes the serialized packet
+	TokenType serializedTokenLength;
+	PcktInterface->BufferPacket.readbuff_PackLength(&serializedTokenLength);
+	int serializedBytes = (int)serializedTokenLength.uintVal;
 
 	// return true or false as error indication, true means all is well
 	// true will permit sending by the output packet interface instance
+	if (serializedBytes < (int)(Packet_HDRPACK::TokenCount * sizeof(TokenType)) || serializedBytes > PacketBytesCapacity || (serializedBytes % sizeof(TokenType)) != 0)
+		return false;
+
+	// conditionally swap byte order of all tokens before sending, in one pass
+	if (PcktInterface->isWireByteOrderSwapped())
+		Packet::swapTokenByteOrder(&PcktInterface->TokenBuffer.bytes[0], serializedBytes / sizeof(TokenType), sizeof(TokenType));
+
+	// the trailer checks the bytes as sent
+	if (PcktInterface->FrameChecked)
+	{
+		AppendFrameCheck(&PcktInterface->TokenBuffer.bytes[0], serializedBytes);
+		serializedBytes += FrameCheckBytes;
+	}
+
+	PcktInterface->serializedPacketSize = serializedBytes;
+	return true;
+}
+
+template<class TokenType, int TokenCapacity>
+void PacketInterface_Binary<TokenType, TokenCapacity>::AppendFrameCheck(uint8_t* bytesPtr, int numBytes)
+{
+	uint32_t crcVal = Packet::CRC32C(bytesPtr, numBytes);
+	for (int i = 0; i < FrameCheckBytes; i++)
+		bytesPtr[numBytes + i] = (i < (int)sizeof(uint32_t)) ? (uint8_t)(crcVal >> (8 * i)) : 0x00;
+}
+
+template<class TokenType, int TokenCapacity>
+bool PacketInterface_Binary<TokenType, TokenCapacity>::isFrameCheckValid(const uint8_t* bytesPtr, int numBytes)
+{
+	uint32_t crcVal = Packet::CRC32C(bytesPtr, numBytes);
+	for (int i = 0; i < FrameCheckBytes; i++)
+		if (bytesPtr[numBytes + i] != ((i < (int)sizeof(uint32_t)) ? (uint8_t)(crcVal >> (8 * i)) : 0x00))
+			return false;
 	return true;
 }
 
-template<class TokenType>
-bool PacketInterface_Binary<TokenType>::DeSerializePacket()
+template<class TokenType, int TokenCapacity>
+bool PacketInterface_Binary<TokenType, TokenCapacity>::DeSerializePacket()
 {
 	return DeSerializePacket_Binary(this);
 }
 
-template<class TokenType>
-bool PacketInterface_Binary<TokenType>::SerializePacket()
+template<class TokenType, int TokenCapacity>
+bool PacketInterface_Binary<TokenType, TokenCapacity>::SerializePacket()
 {
 	return SerializePacket_Binary(this);
 }
 
-template<class TokenType>
-Packet* PacketInterface_Binary<TokenType>::getPacketPtr() { return &BufferPacket; }
+template<class TokenType, int TokenCapacity>
+int PacketInterface_Binary<TokenType, TokenCapacity>::DeSerializePackets(struct PacketFrame* framesPtr, int maxFrames)
+{
+	int numBytesFramed = 0;
+	int numFrames;
+
+	// a packet partially assembled in the interface buffer is completed by DeSerializePacket first
+	if (ByteIndex != 0 || framesPtr == nullptr)
+		return 0;
+
+	FramesBytesPtr = RxRing.getReadPtr();
+	numFrames = FramePackets_Binary(this, FramesBytesPtr, RxRing.getContiguousCount(), framesPtr, maxFrames, &numBytesFramed);
+	RxRing.Consume(numBytesFramed);
+	return numFrames;
+}
+
+template<class TokenType, int TokenCapacity>
+uint8_t* PacketInterface_Binary<TokenType, TokenCapacity>::getFramesBuffer() { return FramesBytesPtr; }
 
-template<class TokenType>
-int		PacketInterface_Binary<TokenType>::getTokenSize() { return sizeof(TokenType); }
+template<class TokenType, int TokenCapacity>
+bool PacketInterface_Binary<TokenType, TokenCapacity>::BindFramePacket(Packet* PacketPtr, const struct PacketFrame* framePtr)
+{
+	if (PacketPtr == nullptr || PacketPtr == &BufferPacket || framePtr == nullptr || FramesBytesPtr == nullptr)
+		return false;
+	PacketPtr->setBytesBuffer(FramesBytesPtr + framePtr->Offset, framePtr->Length, sizeof(TokenType));
+	return true;
+}
 
-template<class TokenType>
-PacketInterface_Binary<TokenType>::PacketInterface_Binary(std::iostream* ifaceStreamPtrIn) :
+template<class TokenType, int TokenCapacity>
+bool PacketInterface_Binary<TokenType, TokenCapacity>::DeSerializeFrame()
+{
+	// the interface buffer is bound again before framing, DeSerializePacket assembles packets there
+	if (RxFrameIndex >= NumRxFrames)
+	{
+		BufferPacket.setBytesBuffer(&(TokenBuffer.bytes[0]), PacketBytesCapacity, sizeof(TokenType));
+		NumRxFrames = DeSerializePackets(RxFrames, PACKETINTERFACE_FRAMECOUNT);
+		RxFrameIndex = 0;
+		if (NumRxFrames == 0)
+			return DeSerializePacket();
+	}
+	BufferPacket.setBytesBuffer(FramesBytesPtr + RxFrames[RxFrameIndex].Offset, RxFrames[RxFrameIndex].Length, sizeof(TokenType));
+	RxFrameIndex++;
+	return true;
+}
+
+template<class TokenType, int TokenCapacity>
+enum PacketTypes PacketInterface_Binary<TokenType, TokenCapacity>::getFramePacketType(const struct PacketFrame* framePtr)
+{
+	TokenType x_SPD;
+	if (FramesBytesPtr == nullptr || framePtr == nullptr)
+		return packType_ReadComplete;
+	PacketView<Packet_HDRPACK> hView(FramesBytesPtr + framePtr->Offset, framePtr->Length, sizeof(TokenType));
+
+	if (!hView.template readbuff<Packet_HDRPACK::Field_PacketType>(&x_SPD))
+		return packType_ReadComplete;
+	return ((enum PacketTypes)(x_SPD.intVal));
+}
+
+template<class TokenType, int TokenCapacity>
+Packet* PacketInterface_Binary<TokenType, TokenCapacity>::getPacketPtr() { return &BufferPacket; }
+
+template<class TokenType, int TokenCapacity>
+int		PacketInterface_Binary<TokenType, TokenCapacity>::getTokenSize() { return sizeof(TokenType); }
+
+template<class TokenType, int TokenCapacity>
+int		PacketInterface_Binary<TokenType, TokenCapacity>::getTokenCapacity() { return TokenCapacity; }
+
+template<class TokenType, int TokenCapacity>
+int		PacketInterface_Binary<TokenType, TokenCapacity>::getPacketOption()
+{
+	TokenType x_SPD;
+	PacketView<Packet_HDRPACK> hView(&BufferPacket);
+
+	if (!hView.template readbuff<Packet_HDRPACK::Field_PacketOption>(&x_SPD))
+		return 0;
+	return (int)x_SPD.intVal;
+}
+
+template<class TokenType, int TokenCapacity>
+enum PacketTypes	PacketInterface_Binary<TokenType, TokenCapacity>::getPacketType()
+{
+	TokenType x_SPD;
+	PacketView<Packet_HDRPACK> hView(&BufferPacket);
+
+	if (!hView.template readbuff<Packet_HDRPACK::Field_PacketType>(&x_SPD))
+		return packType_ReadComplete;
+	return ((enum PacketTypes)(x_SPD.intVal));
+}
+
+template<class TokenType, int TokenCapacity>
+bool	PacketInterface_Binary<TokenType, TokenCapacity>::isWireByteOrderSwapped() { return (sizeof(TokenType) > 1 && !Packet::isHostByteOrder(WireByteOrder)); }
+
+template<class TokenType, int TokenCapacity>
+void	PacketInterface_Binary<TokenType, TokenCapacity>::setWireByteOrder(enum SPDByteOrderEnum byteOrderIn) { WireByteOrder = byteOrderIn; }
+
+template<class TokenType, int TokenCapacity>
+enum SPDByteOrderEnum	PacketInterface_Binary<TokenType, TokenCapacity>::getWireByteOrder() { return WireByteOrder; }
+
+template<class TokenType, int TokenCapacity>
+void	PacketInterface_Binary<TokenType, TokenCapacity>::setFrameCheck(bool isFrameCheckedIn) { FrameChecked = isFrameCheckedIn; }
+
+template<class TokenType, int TokenCapacity>
+bool	PacketInterface_Binary<TokenType, TokenCapacity>::isFrameChecked() { return FrameChecked; }
+
+template<class TokenType, int TokenCapacity>
+int		PacketInterface_Binary<TokenType, TokenCapacity>::getFrameCheckErrorCount() { return FrameCheckErrors; }
+
+template<class TokenType, int TokenCapacity>
+PacketInterface_Binary<TokenType, TokenCapacity>::PacketInterface_Binary(std::iostream* ifaceStreamPtrIn) :
 	PacketInterface(ifaceStreamPtrIn) {
-	BufferPacket.setBytesBuffer(&(TokenBuffer.bytes[0]));
+	BufferPacket.setBytesBuffer(&(TokenBuffer.bytes[0]), PacketBytesCapacity, sizeof(TokenType));
 }
-template<class TokenType>
-PacketInterface_Binary<TokenType>::PacketInterface_Binary(std::istream* ifaceInStreamPtrIn) :
+template<class TokenType, int TokenCapacity>
+PacketInterface_Binary<TokenType, TokenCapacity>::PacketInterface_Binary(std::istream* ifaceInStreamPtrIn) :
 	PacketInterface(ifaceInStreamPtrIn) {
-	BufferPacket.setBytesBuffer(&(TokenBuffer.bytes[0]));
+	BufferPacket.setBytesBuffer(&(TokenBuffer.bytes[0]), PacketBytesCapacity, sizeof(TokenType));
 }
-template<class TokenType>
-PacketInterface_Binary<TokenType>::PacketInterface_Binary(std::ostream* ifaceOutStreamPtrIn) :
+template<class TokenType, int TokenCapacity>
+PacketInterface_Binary<TokenType, TokenCapacity>::PacketInterface_Binary(std::ostream* ifaceOutStreamPtrIn) :
 	PacketInterface(ifaceOutStreamPtrIn) {
-	BufferPacket.setBytesBuffer(&(TokenBuffer.bytes[0]));
+	BufferPacket.setBytesBuffer(&(TokenBuffer.bytes[0]), PacketBytesCapacity, sizeof(TokenType));
 }
 
 #pragma endregion
 
-#pragma region PacketInterface_ASCII Implementation
+#pragma region PacketInterface_ASCIIBase Implementation
 
 
-void PacketInterface_ASCII::WriteToStream_ASCII(PacketInterface_ASCII* PcktInterface, std::ostream* PcktInterfaceStream)
+void PacketInterface_ASCIIBase::WriteToStream_ASCII(PacketInterface_ASCIIBase* PcktInterface, std::ostream* PcktInterfaceStream)
 {
-	PcktInterfaceStream->write(&(PcktInterface->TokenBuffer.chars[0]), PcktInterface->serializedPacketSize);
+	PcktInterfaceStream->write(PcktInterface->TokenChars, PcktInterface->serializedPacketSize);
 }
-void PacketInterface_ASCII::WriteToStream_ASCII(PacketInterface_ASCII* PcktInterface, std::iostream* PcktInterfaceStream)
+void PacketInterface_ASCIIBase::WriteToStream_ASCII(PacketInterface_ASCIIBase* PcktInterface, std::iostream* PcktInterfaceStream)
 {
-	PcktInterfaceStream->write(&(PcktInterface->TokenBuffer.chars[0]), PcktInterface->serializedPacketSize);
+	PcktInterfaceStream->write(PcktInterface->TokenChars, PcktInterface->serializedPacketSize);
 }
-void PacketInterface_ASCII::WriteToStream()
+void PacketInterface_ASCIIBase::WriteToStream()
 {
 	if (ifaceStreamPtr != nullptr)
 		WriteToStream_ASCII(this, ifaceStreamPtr);
@@ -156,19 +360,15 @@ void PacketInterface_ASCII::WriteToStream()
 }
 
 
-void PacketInterface_ASCII::ReadFromStream_ASCII(PacketInterface_ASCII* PcktInterface, std::istream* PcktInterfaceStream)
+void PacketInterface_ASCIIBase::ReadFromStream_ASCII(PacketInterface_ASCIIBase* PcktInterface, std::istream* PcktInterfaceStream)
 {
-	if (PcktInterfaceStream->peek() != EOF)
-		PcktInterfaceStream->read(&(PcktInterface->TokenBuffer.chars[PcktInterface->CharIndex++]), 1);
-
+	PcktInterface->RxRing.FillFromStream(PcktInterfaceStream);
 }
-void PacketInterface_ASCII::ReadFromStream_ASCII(PacketInterface_ASCII* PcktInterface, std::iostream* PcktInterfaceStream)
+void PacketInterface_ASCIIBase::ReadFromStream_ASCII(PacketInterface_ASCIIBase* PcktInterface, std::iostream* PcktInterfaceStream)
 {
-	if (PcktInterfaceStream->peek() != EOF)
-		PcktInterfaceStream->read(&(PcktInterface->TokenBuffer.chars[PcktInterface->CharIndex++]), 1);
-
+	PcktInterface->RxRing.FillFromStream(PcktInterfaceStream);
 }
-void PacketInterface_ASCII::ReadFromStream()
+void PacketInterface_ASCIIBase::ReadFromStream()
 {
 	if (ifaceStreamPtr != nullptr)
 	{
@@ -180,41 +380,56 @@ void PacketInterface_ASCII::ReadFromStream()
 	}
 }
 
-void PacketInterface_ASCII::ResetdeSerialize()
+void PacketInterface_ASCIIBase::ResetdeSerialize()
 {
 	CharIndex = 0;
-	CharIndexLast = 0;
 	deSerializedTokenIndex = 0;
 	deSerializeReset = false;
 }
 
-bool PacketInterface_ASCII::DeSerializePacket_ASCII(PacketInterface_ASCII* PcktInterface)
+bool PacketInterface_ASCIIBase::DeSerializePacket_ASCII(PacketInterface_ASCIIBase* PcktInterface)
 {
 	// called cyclically
-	// monitor CharIndex for change
-	if (PcktInterface->CharIndexLast != PcktInterface->CharIndex)
+	// consume the receive ring char by char, until a packet is complete or the ring is empty
+	while (!PcktInterface->RxRing.isEmpty())
 	{
+		// never beyond the token buffer
+		if (PcktInterface->CharIndex >= STRINGBUFFER_CHARCOUNT_OF(PcktInterface->TokenCapacity))
+		{
+			PcktInterface->ResetdeSerialize();
+			continue;
+		}
+		PcktInterface->RxRing.Read((uint8_t*)&PcktInterface->TokenChars[PcktInterface->CharIndex++], 1);
+
 		int lastIndex = PcktInterface->CharIndex - 1;
+		int NextTokenStart = (STRINGBUFFER_IDTOKENRATIO + PcktInterface->deSerializedTokenIndex * STRINGBUFFER_TOKENRATIO);
+		int TokenStart = (PcktInterface->deSerializedTokenIndex == 0) ? 0 : NextTokenStart - STRINGBUFFER_TOKENRATIO;
+		bool isTokenEnd = (Packet::isDelimiterchar(PcktInterface->TokenChars[lastIndex]) || Packet::isTerminatorchar(PcktInterface->TokenChars[lastIndex]));
 
 		// decide if error, trigger reset
-		if (!Packet::isASCIIchar(PcktInterface->TokenBuffer.chars[lastIndex]) || PcktInterface->TokenBuffer.chars[lastIndex] == ASCII_lf || PcktInterface->TokenBuffer.chars[lastIndex] == ASCII_cr)
+		// line breaks between packets, tokens without room for a terminator, or tokens beyond the buffer
+		if (PcktInterface->TokenChars[lastIndex] == ASCII_lf || PcktInterface->TokenChars[lastIndex] == ASCII_cr
+			|| (!isTokenEnd && lastIndex >= NextTokenStart - 1) || PcktInterface->deSerializedTokenIndex >= PcktInterface->TokenCapacity)
 		{
-			PcktInterface->deSerializeReset = true; // TODO:  ??
+			PcktInterface->deSerializeReset = true;
 		}
 		// look for delimeter/terminator ?
-		else if (Packet::isDelimiterchar(PcktInterface->TokenBuffer.chars[lastIndex]) || Packet::isTerminatorchar(PcktInterface->TokenBuffer.chars[lastIndex]))
+		else if (isTokenEnd)
 		{
-			int NextTokenStart = (STRINGBUFFER_IDTOKENRATIO + PcktInterface->deSerializedTokenIndex * STRINGBUFFER_TOKENRATIO);
-
+			// validate the completed token, all chars at once
+			if (!Packet::isPrintableString(&PcktInterface->TokenChars[TokenStart], lastIndex - TokenStart))
+			{
+				PcktInterface->deSerializeReset = true;
+			}
 			// decide if complete packet
 			// return true or false
 			// true will trigger the rx packet handler of the data execution instance
-			if (Packet::isTerminatorchar(PcktInterface->TokenBuffer.chars[lastIndex]))
+			else if (Packet::isTerminatorchar(PcktInterface->TokenChars[lastIndex]))
 			{
 				// "strip" terminator
 				// 0x00 to all chars from terminator to next token start
 				for (int i = lastIndex; i < NextTokenStart; i++)
-					PcktInterface->TokenBuffer.chars[i] = 0x00;
+					PcktInterface->TokenChars[i] = 0x00;
 
 				// increment token index
 				PcktInterface->deSerializedTokenIndex++;
@@ -231,7 +446,7 @@ bool PacketInterface_ASCII::DeSerializePacket_ASCII(PacketInterface_ASCII* PcktI
 				// "strip" delimiter
 				// 0x00 to all chars from delimiter to next token start
 				for (int i = lastIndex; i < (STRINGBUFFER_IDTOKENRATIO + PcktInterface->deSerializedTokenIndex * STRINGBUFFER_TOKENRATIO); i++)
-					PcktInterface->TokenBuffer.chars[i] = 0x00;
+					PcktInterface->TokenChars[i] = 0x00;
 
 
 				// advance index to next token start
@@ -240,25 +455,133 @@ bool PacketInterface_ASCII::DeSerializePacket_ASCII(PacketInterface_ASCII* PcktI
 				PcktInterface->deSerializedTokenIndex++;
 			}
 		}
+
+		// reset if triggered, framing restarts at the next char in the ring
+		if (PcktInterface->deSerializeReset)
+		{
+			PcktInterface->ResetdeSerialize();
+		}
 	}
+	return false;
+}
 
-	// reset if triggered
-	if (PcktInterface->deSerializeReset)
+bool PacketInterface_ASCIIBase::DeSerializePacket()
+{
+	return DeSerializePacket_ASCII(this);
+}
+
+int PacketInterface_ASCIIBase::FramePackets_ASCII(PacketInterface_ASCIIBase* PcktInterface, const char* charsPtr, int numChars, struct PacketFrame* framesPtr, int maxFrames, int* numCharsFramedPtr)
+{
+	return FramePackets_ASCII(PcktInterface->TokenCapacity, charsPtr, numChars, framesPtr, maxFrames, numCharsFramedPtr);
+}
+int PacketInterface_ASCIIBase::FramePackets_ASCII(int TokenCapacity, const char* charsPtr, int numChars, struct PacketFrame* framesPtr, int maxFrames, int* numCharsFramedPtr)
+{
+	// called single-shot over a whole range
+	// step from token boundary to token boundary, until the range or the frames run out
+	int numFrames = 0;
+	int packetStart = 0;
+	int tokenStart = 0;
+	int tokenIndex = 0;
+
+	while (numFrames < maxFrames && tokenStart < numChars)
 	{
-		PcktInterface->ResetdeSerialize();
+		int tokenEnd = tokenStart + Packet::scanTokenBoundary(&charsPtr[tokenStart], numChars - tokenStart);
+		int maxTokenLength = ((tokenIndex == Index_PackID) ? STRINGBUFFER_IDTOKENRATIO : STRINGBUFFER_TOKENRATIO) - 1;
+
+		// a partial packet waits for more chars, unless its token can no longer fit its slot
+		if (tokenEnd == numChars)
+		{
+			if (tokenEnd - tokenStart > maxTokenLength)
+				packetStart = numChars;
+			break;
+		}
+
+		// decide if error, restart framing after the boundary char
+		// line breaks between packets, invalid chars, tokens without room for a terminator, or tokens beyond the buffer
+		if (!(Packet::isDelimiterchar(charsPtr[tokenEnd]) || Packet::isTerminatorchar(charsPtr[tokenEnd]))
+			|| tokenEnd - tokenStart > maxTokenLength || tokenIndex >= TokenCapacity
+			|| (Packet::isTerminatorchar(charsPtr[tokenEnd]) && tokenIndex + 1 < Packet_HDRPACK::TokenCount))
+		{
+			packetStart = tokenEnd + 1;
+			tokenStart = packetStart;
+			tokenIndex = 0;
+		}
+		else if (Packet::isDelimiterchar(charsPtr[tokenEnd]))
+		{
+			tokenStart = tokenEnd + 1;
+			tokenIndex++;
+		}
+		else
+		{
+			framesPtr[numFrames].Offset = packetStart;
+			framesPtr[numFrames].Length = tokenEnd + 1 - packetStart;
+			numFrames++;
+			packetStart = tokenEnd + 1;
+			tokenStart = packetStart;
+			tokenIndex = 0;
+		}
 	}
 
-	// Capture history for change detect
-	PcktInterface->CharIndexLast = PcktInterface->CharIndex;
-	return false;
+	*numCharsFramedPtr = packetStart;
+	return numFrames;
 }
 
-bool PacketInterface_ASCII::DeSerializePacket()
+int PacketInterface_ASCIIBase::DeSerializePackets(struct PacketFrame* framesPtr, int maxFrames)
 {
-	return DeSerializePacket_ASCII(this);
+	int numCharsFramed = 0;
+	int numFrames;
+
+	// a packet partially assembled in the interface buffer is completed by DeSerializePacket first
+	if (CharIndex != 0 || framesPtr == nullptr)
+		return 0;
+
+	FramesCharsPtr = (char*)RxRing.getReadPtr();
+	numFrames = FramePackets_ASCII(this, FramesCharsPtr, RxRing.getContiguousCount(), framesPtr, maxFrames, &numCharsFramed);
+	RxRing.Consume(numCharsFramed);
+	return numFrames;
+}
+
+char* PacketInterface_ASCIIBase::getFramesBuffer() { return FramesCharsPtr; }
+
+bool PacketInterface_ASCIIBase::SlotFramePacket(const struct PacketFrame* framePtr)
+{
+	if (framePtr == nullptr || FramesCharsPtr == nullptr)
+		return false;
+
+	// copy each token to its slot, 0x00 to the rest of the slot
+	const char* frameCharsPtr = FramesCharsPtr + framePtr->Offset;
+	int tokenStart = 0;
+	for (int i = 0; tokenStart < framePtr->Length && i < TokenCapacity; i++)
+	{
+		int tokenLength = Packet::scanTokenBoundary(&frameCharsPtr[tokenStart], framePtr->Length - tokenStart);
+		int slotStart = (i == Index_PackID) ? 0 : STRINGBUFFER_IDTOKENRATIO + (i - 1) * STRINGBUFFER_TOKENRATIO;
+		int slotLength = (i == Index_PackID) ? STRINGBUFFER_IDTOKENRATIO : STRINGBUFFER_TOKENRATIO;
+		if (tokenLength >= slotLength)
+			return false;
+		memcpy(&TokenChars[slotStart], &frameCharsPtr[tokenStart], tokenLength);
+		memset(&TokenChars[slotStart + tokenLength], 0x00, slotLength - tokenLength);
+		tokenStart += tokenLength + 1;
+	}
+	return true;
+}
+
+bool PacketInterface_ASCIIBase::DeSerializeFrame()
+{
+	while (true)
+	{
+		if (RxFrameIndex >= NumRxFrames)
+		{
+			NumRxFrames = DeSerializePackets(RxFrames, PACKETINTERFACE_FRAMECOUNT);
+			RxFrameIndex = 0;
+			if (NumRxFrames == 0)
+				return DeSerializePacket();
+		}
+		if (SlotFramePacket(&RxFrames[RxFrameIndex++]))
+			return true;
+	}
 }
 
-bool PacketInterface_ASCII::SerializePacket_ASCII(PacketInterface_ASCII* PcktInterface)
+bool PacketInterface_ASCIIBase::SerializePacket_ASCII(PacketInterface_ASCIIBase* PcktInterface)
 {
 	// called single-shot
 	int lastCharIndexWritten = 0;	// initialized to start of id string
@@ -267,7 +590,7 @@ bool PacketInterface_ASCII::SerializePacket_ASCII(PacketInterface_ASCII* PcktInt
 	int k;
 
 	// iterate through token buffer by token index
-	for (int i = 0; i < PACKETBUFFER_TOKENCOUNT; i++)
+	for (int i = 0; i < PcktInterface->TokenCapacity; i++)
 	{
 		// calculate inner loop bounds
 		if (i == 0)
@@ -287,9 +610,9 @@ bool PacketInterface_ASCII::SerializePacket_ASCII(PacketInterface_ASCII* PcktInt
 			if (i == Index_PackID)	// working the ID string
 			{
 				// adorn each token at first occurance of 0x00, replace with delimiter
-				if (PcktInterface->TokenBuffer.chars[j] == 0x00)
+				if (PcktInterface->TokenChars[j] == 0x00)
 				{
-					PcktInterface->TokenBuffer.chars[j] = ASCII_colon;
+					PcktInterface->TokenChars[j] = ASCII_colon;
 					lastCharIndexWritten = j;	// latch index of last char "written"
 					break; // break from inner loop, token by char, loop
 				}
@@ -297,28 +620,31 @@ bool PacketInterface_ASCII::SerializePacket_ASCII(PacketInterface_ASCII* PcktInt
 			else // working all inner tokens (not first or last)
 			{
 				// adorn each token at first occurance of 0x00
-				if (PcktInterface->TokenBuffer.chars[j] == 0x00)
+				if (PcktInterface->TokenChars[j] == 0x00)
 				{
 					if (i == Index_PackLEN) // working the SPD Count String
 					{
-						SerializedTokenCount = atoi(&PcktInterface->TokenBuffer.chars[STRINGBUFFER_IDTOKENRATIO + (i - 1) * STRINGBUFFER_TOKENRATIO]);
+						int64_t parsedTokenCount;
+						if (!TokenStringCodec::ParseSigned(&PcktInterface->TokenChars[STRINGBUFFER_IDTOKENRATIO + (i - 1) * STRINGBUFFER_TOKENRATIO], STRINGBUFFER_TOKENRATIO, &parsedTokenCount))
+							return false;
 
 						// an error has occurred with the token count string if parsed token count string less than hdr packet token count
-						if (SerializedTokenCount < Packet_HDRPACK::TokenCount)
+						if (parsedTokenCount < Packet_HDRPACK::TokenCount || parsedTokenCount > PcktInterface->TokenCapacity)
 							return false;
+						SerializedTokenCount = (int)parsedTokenCount;
 					}
 
 					// add delimiter/terminator to shifted location
 					if (i == (SerializedTokenCount - 1)) // working the final token string
 					{
-						PcktInterface->TokenBuffer.chars[++lastCharIndexWritten] = ASCII_semicolon;
-						PcktInterface->TokenBuffer.chars[++lastCharIndexWritten] = ASCII_lf;
+						PcktInterface->TokenChars[++lastCharIndexWritten] = ASCII_semicolon;
+						PcktInterface->TokenChars[++lastCharIndexWritten] = ASCII_lf;
 						PcktInterface->serializedPacketSize = lastCharIndexWritten + 1;
 						return true;
 					}
 					else
 					{
-						PcktInterface->TokenBuffer.chars[++lastCharIndexWritten] = ASCII_colon;
+						PcktInterface->TokenChars[++lastCharIndexWritten] = ASCII_colon;
 						break; // break from inner loop, token by char, loop
 					}
 
@@ -327,53 +653,171 @@ bool PacketInterface_ASCII::SerializePacket_ASCII(PacketInterface_ASCII* PcktInt
 				else
 				{
 					// shift chars down to previous token delimiter
-					PcktInterface->TokenBuffer.chars[++lastCharIndexWritten] = PcktInterface->TokenBuffer.chars[j];
+					PcktInterface->TokenChars[++lastCharIndexWritten] = PcktInterface->TokenChars[j];
 				}
 			}
 		}
 	}
 	return false;
 }
-bool PacketInterface_ASCII::SerializePacket()
+bool PacketInterface_ASCIIBase::SerializePacket()
 {
+	// an emitted packet is already serialized, once
+	if (isEmitted)
+	{
+		isEmitted = false;
+		return true;
+	}
 	return SerializePacket_ASCII(this);
 }
-int PacketInterface_ASCII::getPacketOption()
+bool PacketInterface_ASCIIBase::EmittedPacket(int numChars)
+{
+	isEmitted = (numChars > 0 && numChars <= STRINGBUFFER_CHARCOUNT_OF(TokenCapacity));
+	if (isEmitted)
+		serializedPacketSize = numChars;
+	return isEmitted;
+}
+int PacketInterface_ASCIIBase::getPacketOption()
 {
 	SPD4 x_SPD;
-	Packet_HDRPACK hPack;
-	hPack.CopyTokenBufferPtrs(getPacketPtr());
+	PacketView<Packet_HDRPACK> hView(&BufferPacket);
 
-	hPack.getfromStringPacketOption(&x_SPD);
+	x_SPD.intVal = 0;
+	hView.getfromString<Packet_HDRPACK::Field_PacketOption>(&x_SPD);
 
 	return x_SPD.intVal;
 }
-enum PacketTypes	PacketInterface_ASCII::getPacketType()
+enum PacketTypes	PacketInterface_ASCIIBase::getPacketType()
 {
 	SPD4 x_SPD;
-	Packet_HDRPACK hPack;
-	hPack.CopyTokenBufferPtrs(getPacketPtr());
+	PacketView<Packet_HDRPACK> hView(&BufferPacket);
 
-	hPack.getfromStringPacketType(&x_SPD);
+	x_SPD.intVal = packType_ReadComplete;
+	hView.getfromString<Packet_HDRPACK::Field_PacketType>(&x_SPD);
 
 	return ((enum PacketTypes)(x_SPD.intVal));
 }
-Packet* PacketInterface_ASCII::getPacketPtr() { return &BufferPacket; }
-int		PacketInterface_ASCII::getTokenSize() { return STRINGBUFFER_TOKENRATIO; }
-PacketInterface_ASCII::PacketInterface_ASCII(std::iostream* ifaceStreamPtrIn) :
-	PacketInterface(ifaceStreamPtrIn) {
-	BufferPacket.setCharsBuffer(&(TokenBuffer.chars[0]));
+Packet* PacketInterface_ASCIIBase::getPacketPtr() { return &BufferPacket; }
+int		PacketInterface_ASCIIBase::getTokenSize() { return STRINGBUFFER_TOKENRATIO; }
+int		PacketInterface_ASCIIBase::getTokenCapacity() { return TokenCapacity; }
+PacketInterface_ASCIIBase::PacketInterface_ASCIIBase(char* TokenCharsIn, int TokenCapacityIn, std::iostream* ifaceStreamPtrIn) :
+	PacketInterface(ifaceStreamPtrIn), TokenChars(TokenCharsIn), TokenCapacity(TokenCapacityIn) {
+	BufferPacket.setCharsBuffer(TokenChars, STRINGBUFFER_CHARCOUNT_OF(TokenCapacity));
 }
-PacketInterface_ASCII::PacketInterface_ASCII(std::istream* ifaceInStreamPtrIn) :
-	PacketInterface(ifaceInStreamPtrIn) {
-	BufferPacket.setCharsBuffer(&(TokenBuffer.chars[0]));
+PacketInterface_ASCIIBase::PacketInterface_ASCIIBase(char* TokenCharsIn, int TokenCapacityIn, std::istream* ifaceInStreamPtrIn) :
+	PacketInterface(ifaceInStreamPtrIn), TokenChars(TokenCharsIn), TokenCapacity(TokenCapacityIn) {
+	BufferPacket.setCharsBuffer(TokenChars, STRINGBUFFER_CHARCOUNT_OF(TokenCapacity));
 }
-PacketInterface_ASCII::PacketInterface_ASCII(std::ostream* ifaceOutStreamPtrIn) :
-	PacketInterface(ifaceOutStreamPtrIn) {
-	BufferPacket.setCharsBuffer(&(TokenBuffer.chars[0]));
+PacketInterface_ASCIIBase::PacketInterface_ASCIIBase(char* TokenCharsIn, int TokenCapacityIn, std::ostream* ifaceOutStreamPtrIn) :
+	PacketInterface(ifaceOutStreamPtrIn), TokenChars(TokenCharsIn), TokenCapacity(TokenCapacityIn) {
+	BufferPacket.setCharsBuffer(TokenChars, STRINGBUFFER_CHARCOUNT_OF(TokenCapacity));
 }
 
 
+#pragma endregion
+
+#pragma region PacketInterface_ASCIICompactBase Implementation
+
+PacketInterface_ASCIICompactBase::PacketInterface_ASCIICompactBase(struct PacketTokenSpan* TokenSpansIn, int TokenCapacityIn, std::iostream* ifaceStreamPtrIn) :
+	PacketInterface(ifaceStreamPtrIn), TokenSpans(TokenSpansIn), TokenCapacity(TokenCapacityIn) {
+	memset(TokenSpans, 0, TokenCapacity * sizeof(struct PacketTokenSpan));
+}
+PacketInterface_ASCIICompactBase::PacketInterface_ASCIICompactBase(struct PacketTokenSpan* TokenSpansIn, int TokenCapacityIn, std::istream* ifaceInStreamPtrIn) :
+	PacketInterface(ifaceInStreamPtrIn), TokenSpans(TokenSpansIn), TokenCapacity(TokenCapacityIn) {
+	memset(TokenSpans, 0, TokenCapacity * sizeof(struct PacketTokenSpan));
+}
+
+void PacketInterface_ASCIICompactBase::WriteToStream() { ; }
+void PacketInterface_ASCIICompactBase::ReadFromStream()
+{
+	if (ifaceStreamPtr != nullptr)
+		RxRing.FillFromStream(ifaceStreamPtr);
+	else if (ifaceInStreamPtr != nullptr)
+		RxRing.FillFromStream(ifaceInStreamPtr);
+}
+
+// a framed packet, from its ID string through its terminator, is valid, so each token ends at a delimiter or the terminator
+void PacketInterface_ASCIICompactBase::SpanFramePacket(char* frameCharsPtr, int frameLength)
+{
+	int tokenStart = 0;
+	int i = 0;
+	while (tokenStart < frameLength && i < TokenCapacity)
+	{
+		int tokenLength = Packet::scanTokenBoundary(&frameCharsPtr[tokenStart], frameLength - tokenStart);
+		TokenSpans[i].Offset = (uint16_t)tokenStart;
+		TokenSpans[i++].Length = (uint16_t)tokenLength;
+		frameCharsPtr[tokenStart + tokenLength] = 0x00;
+		tokenStart += tokenLength + 1;
+	}
+	for (; i < TokenCapacity; i++)
+	{
+		TokenSpans[i].Offset = (uint16_t)(frameLength - 1);
+		TokenSpans[i].Length = 0;
+	}
+	BufferPacket.setCharsBuffer(frameCharsPtr, frameLength);
+	BufferPacket.setCharsSpans(TokenSpans);
+}
+
+bool PacketInterface_ASCIICompactBase::DeSerializePacket()
+{
+	struct PacketFrame rxFrame;
+	int numCharsFramed;
+
+	// the previous packet is consumed only now, it was read in place
+	RxRing.Consume(HeldChars);
+	HeldChars = 0;
+	BufferPacket.setCharsBuffer(nullptr, 0);
+
+	while (!RxRing.isEmpty())
+	{
+		char* readCharsPtr = (char*)RxRing.getReadPtr();
+		if (PacketInterface_ASCIIBase::FramePackets_ASCII(TokenCapacity, readCharsPtr, RxRing.getContiguousCount(), &rxFrame, 1, &numCharsFramed) == 1)
+		{
+			SpanFramePacket(readCharsPtr + rxFrame.Offset, rxFrame.Length);
+			HeldChars = numCharsFramed;
+			return true;
+		}
+
+		// chars before a partial packet are not packets, a partial packet that wraps is made contiguous
+		RxRing.Consume(numCharsFramed);
+		if (RxRing.getContiguousCount() == RxRing.getCount())
+		{
+			// a full ring without a packet can only be cleared
+			if (RxRing.getSpace() == 0)
+				RxRing.Clear();
+			return false;
+		}
+		RxRing.Linearize();
+	}
+	return false;
+}
+bool PacketInterface_ASCIICompactBase::SerializePacket() { return false; }
+
+int PacketInterface_ASCIICompactBase::getPacketOption()
+{
+	SPD4 x_SPD;
+	PacketView<Packet_HDRPACK> hView(&BufferPacket);
+
+	x_SPD.intVal = 0;
+	hView.getfromString<Packet_HDRPACK::Field_PacketOption>(&x_SPD);
+
+	return x_SPD.intVal;
+}
+enum PacketTypes	PacketInterface_ASCIICompactBase::getPacketType()
+{
+	SPD4 x_SPD;
+	PacketView<Packet_HDRPACK> hView(&BufferPacket);
+
+	x_SPD.intVal = packType_ReadComplete;
+	hView.getfromString<Packet_HDRPACK::Field_PacketType>(&x_SPD);
+
+	return ((enum PacketTypes)(x_SPD.intVal));
+}
+Packet* PacketInterface_ASCIICompactBase::getPacketPtr() { return &BufferPacket; }
+int		PacketInterface_ASCIICompactBase::getTokenSize() { return STRINGBUFFER_TOKENRATIO; }
+int		PacketInterface_ASCIICompactBase::getTokenCapacity() { return TokenCapacity; }
+const struct PacketTokenSpan*	PacketInterface_ASCIICompactBase::getTokenSpans() { return TokenSpans; }
+
 #pragma endregion
 
 
@@ -403,30 +847,30 @@ void API_NODE::Loop()
 
 #pragma region Packet_HDRPACK Members (this is the error packet)
 
+static_assert(std::is_trivially_copyable<PacketView<Packet_HDRPACK>>::value, "packet views are passed and stored by value");
+
 void API_NODE::staticHandler_HDRPACK(Packet* PacketPtr, enum PacketTypes PackType, pSTRUCT(HDRPACK)* dstStruct)
 {
 	SPD4 x_SPD;
-	Packet_HDRPACK inPack;
-	inPack.CopyTokenBufferPtrs(PacketPtr);
+	PacketView<Packet_HDRPACK> hView(PacketPtr);
 
-	if (inPack.isASCIIPacket())
+	if (hView.isASCIIPacket())
 	{
-		if (inPack.getfromStringPacketType(&x_SPD))
+		if (hView.getfromString<Packet_HDRPACK::Field_PacketType>(&x_SPD))
 		{
 			if (x_SPD.intVal == packType_ResponseComplete && dstStruct != nullptr)
 			{
-				if(inPack.getfromStringPacketOption(&x_SPD))
+				if(hView.getfromString<Packet_HDRPACK::Field_PacketOption>(&x_SPD))
 					dstStruct->PackOpt = x_SPD.intVal;
 			}
 		}
 	}
 	else
 	{
-		inPack.getPacketType(&x_SPD);
-		if (x_SPD.intVal == packType_ResponseComplete && dstStruct != nullptr)
+		if (hView.readbuff<Packet_HDRPACK::Field_PacketType>(&x_SPD) && x_SPD.intVal == packType_ResponseComplete && dstStruct != nullptr)
 		{
-			inPack.getPacketOption(&x_SPD);
-			dstStruct->PackOpt = x_SPD.intVal;
+			if (hView.readbuff<Packet_HDRPACK::Field_PacketOption>(&x_SPD))
+				dstStruct->PackOpt = x_SPD.intVal;
 		}
 	}
 }
@@ -434,26 +878,40 @@ void API_NODE::staticHandler_HDRPACK(Packet* PacketPtr, enum PacketTypes PackTyp
 
 bool API_NODE::staticPackager_HDRPACK(Packet* PacketPtr, enum PacketTypes PackType, int PackOption)
 {
-	Packet_HDRPACK outPack;
-	outPack.CopyTokenBufferPtrs(PacketPtr);
+	PacketView<Packet_HDRPACK> hView(PacketPtr);
 
 	SPD4 x_SPD;
 
 	bool tempBool = true;
 
-	outPack.writebuff_PackIDString();
+	tempBool &= hView.writebuff_PackIDString();
 
-	outPack.writebuff_TokenCountString();
+	tempBool &= hView.writebuff_TokenCountString();
 
 	x_SPD.intVal = PackType;
-	tempBool &= outPack.set2StringPacketType(&x_SPD);
+	tempBool &= hView.set2String<Packet_HDRPACK::Field_PacketType>(&x_SPD);
 
 	x_SPD.intVal = PackOption;
-	tempBool &= outPack.set2StringPacketOption(&x_SPD);
+	tempBool &= hView.set2String<Packet_HDRPACK::Field_PacketOption>(&x_SPD);
 
 	return tempBool;
 }
 
+bool API_NODE::staticEmitter_HDRPACK(PacketInterface_ASCIIBase* PcktInterface, enum PacketTypes PackType, int PackOption)
+{
+	PacketEmitter<Packet_HDRPACK> hEmitter = PcktInterface->getEmitter<Packet_HDRPACK>();
+
+	SPD4 x_SPD;
+
+	x_SPD.intVal = PackType;
+	hEmitter.emit<Packet_HDRPACK::Field_PacketType>(&x_SPD);
+
+	x_SPD.intVal = PackOption;
+	hEmitter.emit<Packet_HDRPACK::Field_PacketOption>(&x_SPD);
+
+	return PcktInterface->EmittedPacket(hEmitter.finish());
+}
+
 #pragma endregion
 
 
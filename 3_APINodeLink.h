@@ -5,6 +5,7 @@
 #ifndef __APINODELINK__
 #define __APINODELINK__
 #include "3_Packet_VERSION.h"
+#include "2_PacketRegistry.h"
 
 #pragma region HDR Packets Utilize Constant and Code Template Macros 
 /*! \defgroup APINodeLink
@@ -25,16 +26,27 @@ namespace IMSPacketsAPICore
 	
 	/*! \class PacketInterface_Binary
 		\brief API Node Binary Interface for HDR_Packets
+
+		The interface buffer holds TokenCapacity tokens, PACKETBUFFER_TOKENCOUNT by default, and the
+		tokens of a frame check trailer.
 	*/
-	template<class TokenType>
+	template<class TokenType, int TokenCapacity = PACKETBUFFER_TOKENCOUNT>
 	class PacketInterface_Binary : public PacketInterface
 	{
+	public:
+		//! Bytes of the frame check trailer, a CRC32C zero padded to whole tokens
+		static constexpr int			FrameCheckBytes = (int)(((sizeof(uint32_t) + sizeof(TokenType) - 1) / sizeof(TokenType)) * sizeof(TokenType));
+		static constexpr int			PacketBytesCapacity = TokenCapacity * (int)sizeof(TokenType);
+
 	protected:
-		int								ByteIndexLast = 0;
 		Packet_HDRPACK					BufferPacket;
 
 		int								ByteIndex = 0;
-		SPDInterfaceBuffer<TokenType>	TokenBuffer;
+		SPDInterfaceBuffer<TokenType, TokenCapacity + FrameCheckBytes / (int)sizeof(TokenType)>	TokenBuffer;
+		uint8_t*						FramesBytesPtr = nullptr;	// framed range of the last DeSerializePackets
+		struct PacketFrame				RxFrames[PACKETINTERFACE_FRAMECOUNT];	// frames of DeSerializeFrame
+		int								NumRxFrames = 0;
+		int								RxFrameIndex = 0;
 
 		void WriteToStream();
 		void ReadFromStream();
@@ -46,6 +58,14 @@ namespace IMSPacketsAPICore
 		bool deSerializeReset = false;
 		void ResetdeSerialize();
 
+		enum SPDByteOrderEnum WireByteOrder = byteOrder_Native;
+		bool isWireByteOrderSwapped();
+
+		bool FrameChecked = false;
+		int FrameCheckErrors = 0;
+		static void AppendFrameCheck(uint8_t* bytesPtr, int numBytes);
+		static bool isFrameCheckValid(const uint8_t* bytesPtr, int numBytes);
+
 		
 	public:	
 		/*! \fn DeSerializePacket_Binary
@@ -55,7 +75,7 @@ namespace IMSPacketsAPICore
 			Static workhorse function to facilitate testing of customization framework
 			with single validated function, the one used by default.
 		*/
-		static bool DeSerializePacket_Binary(PacketInterface_Binary<TokenType>* PcktInterface);
+		static bool DeSerializePacket_Binary(PacketInterface_Binary<TokenType, TokenCapacity>* PcktInterface);
 		
 
 		/*! \fn SerializePacket_Binary
@@ -65,24 +85,68 @@ namespace IMSPacketsAPICore
 			Static workhorse function to facilitate testing of customization framework
 			with single validated function, the one used by default.
 		*/
-		static bool SerializePacket_Binary(PacketInterface_Binary<TokenType>* PcktInterface);
+		static bool SerializePacket_Binary(PacketInterface_Binary<TokenType, TokenCapacity>* PcktInterface);
+
+		/*! \fn FramePackets_Binary
+			\brief Batch Framing of a Contiguous Byte Range
+			\sa DeSerializePackets
+			\param numBytesFramedPtr set to the count of bytes framed or skipped, a partial packet at the end of the range is not
+			\return the number of complete packets found, at most maxFrames
+
+			Reads the length token of each packet and steps over it, one pass for the whole range.  Lengths
+			shorter than a header, beyond the token buffer, or of partial tokens are skipped as the header
+			tokens they are in, as DeSerializePacket_Binary would reset on them, as are packets failing their
+			frame check.  Packets are converted to host byte order in place, not copied.
+		*/
+		static int FramePackets_Binary(PacketInterface_Binary<TokenType, TokenCapacity>* PcktInterface, uint8_t* bytesPtr, int numBytes, struct PacketFrame* framesPtr, int maxFrames, int* numBytesFramedPtr);
 
 
 		/*! \fn DeSerializePacket
 			\brief Cyclic Non-Blocking Conditional Assembly
 			\sa DeSerializePacket_Binary
 
-			Bytes are intended to enter the system one by one, or at least, token by token.
-			As bytes are read into the packet buffer, this function analyzes the bytes to
-			determine 
+			Bytes enter the system in chunks of any size, staged in the receive ring by ReadFrom.
+			This function consumes the ring token by token into the packet buffer, and analyzes
+			the tokens to determine
 			- the full size of the packet from its length token at index 1, and
 			- when either an error in Deserialization has occurred, or
 			- when a complete packet has been deserialized into the packet interface buffer
 
+			Partial tokens and packets wait in the buffer for the next chunk, and bytes following
+			a complete packet wait in the ring for the next call.
+
 			\return if a complete packet has been deserialized and is ready for handling
 		*/
 		bool DeSerializePacket();
 
+		/*! \fn DeSerializePackets
+			\brief Batch Deserialization of every Complete Packet at the Read Position of the Receive Ring
+			\sa FramePackets_Binary
+			\return the number of frames, at most maxFrames
+
+			Frames locate packets in place, relative to getFramesBuffer(), and are valid until the next
+			ReadFrom.  A packet of the frame is bound to it by BindFramePacket, then handled without copying
+			it into the interface buffer, e.g.
+			\code
+			struct PacketFrame rxFrames[16];
+			int numFrames = rxInterface.DeSerializePackets(rxFrames, 16);
+			for (int i = 0; i < numFrames; i++)
+				if (rxInterface.BindFramePacket(&rxPacket, &rxFrames[i]))
+					registry.DispatchPacket(&rxPacket, rxInterface.getFramePacketType(&rxFrames[i]));
+			\endcode
+			Frames are found in the contiguous bytes of the ring.  When it returns 0 with bytes still in
+			the ring, either a packet is partially assembled by, or wraps the ring and is left for, DeSerializePacket.
+		*/
+		int DeSerializePackets(struct PacketFrame* framesPtr, int maxFrames);
+		uint8_t*	getFramesBuffer();
+		/*! \fn BindFramePacket
+			\brief Bind the byte buffer of a packet, not the interface packet, to a frame of the last DeSerializePackets
+		*/
+		bool		BindFramePacket(Packet* PacketPtr, const struct PacketFrame* framePtr);
+		enum PacketTypes	getFramePacketType(const struct PacketFrame* framePtr);
+		//! Binds the interface packet to each frame in turn, and back to the interface buffer when none remain
+		bool		DeSerializeFrame();
+
 		 
 		/*! \fn SerializePacket
 			\brief Single Shot Non-Blocking Conditional Assembly
@@ -103,6 +167,35 @@ namespace IMSPacketsAPICore
 		*/
 		Packet* getPacketPtr();
 		int		getTokenSize();
+		int		getTokenCapacity();
+		int		getPacketOption();
+		enum PacketTypes	getPacketType();
+
+		/*! \fn setWireByteOrder
+			\brief Configure the byte order of tokens on the link
+
+			Both nodes of a binary link configure the same wire byte order, byteOrder_Network
+			for mixed-endian links.  When the wire byte order differs from the host byte order,
+			the whole token buffer is converted in one pass after deserialization of a complete
+			packet and before transmission of a serialized packet.  Otherwise no conversion is made.
+			The default, byteOrder_Native, never converts.
+		*/
+		void	setWireByteOrder(enum SPDByteOrderEnum byteOrderIn);
+		enum SPDByteOrderEnum	getWireByteOrder();
+
+		/*! \fn setFrameCheck
+			\brief Configure a CRC32C trailer on every packet of the link
+
+			Both nodes of a binary link configure the same frame check.  When set, serialization appends
+			FrameCheckBytes after the packet: the CRC32C of the packet bytes as sent, least significant byte
+			first, zero padded to whole tokens.  The length token still counts the packet bytes only.
+			Deserialization and framing read the trailer and reject a packet whose check fails, as soon as
+			its trailer is received, so a corrupted length can not pass a packet to its handler.  Rejected
+			packets are counted.  Off by default.
+		*/
+		void	setFrameCheck(bool isFrameCheckedIn);
+		bool	isFrameChecked();
+		int		getFrameCheckErrorCount();
 
 		PacketInterface_Binary(std::iostream* ifaceStreamPtrIn = nullptr);
 		PacketInterface_Binary(std::istream* ifaceInStreamPtrIn);
@@ -111,15 +204,23 @@ namespace IMSPacketsAPICore
 	
 	
 	
-	/*! \class PacketInterface_ASCII
+	/*! \class PacketInterface_ASCIIBase
 		\brief API Node ASCII Interface for HDR_Packets
+
+		Serialization and deserialization of string tokens in a char buffer of TokenCapacity tokens.
+		The buffer is allocated by PacketInterface_ASCIISized, so a single implementation serves
+		interfaces of every capacity.
 	*/
-	class PacketInterface_ASCII : public PacketInterface
+	class PacketInterface_ASCIIBase : public PacketInterface
 	{
 	protected:
 		int									CharIndex = 0;
-		int									CharIndexLast = 0;
-		SPDASCIIInterfaceBuffer				TokenBuffer;
+		char*								TokenChars = nullptr;
+		int									TokenCapacity = 0;
+		char*								FramesCharsPtr = nullptr;	// framed range of the last DeSerializePackets
+		struct PacketFrame					RxFrames[PACKETINTERFACE_FRAMECOUNT];	// frames of DeSerializeFrame
+		int									NumRxFrames = 0;
+		int									RxFrameIndex = 0;
 		Packet_HDRPACK						BufferPacket;
 		
 		void WriteToStream();
@@ -129,16 +230,19 @@ namespace IMSPacketsAPICore
 		bool deSerializeReset = false;
 		void ResetdeSerialize();
 
+		bool isEmitted = false;		// the buffer holds a packet serialized by an emitter
+
+		PacketInterface_ASCIIBase(char* TokenCharsIn, int TokenCapacityIn, std::iostream* ifaceStreamPtrIn);
+		PacketInterface_ASCIIBase(char* TokenCharsIn, int TokenCapacityIn, std::istream* ifaceInStreamPtrIn);
+		PacketInterface_ASCIIBase(char* TokenCharsIn, int TokenCapacityIn, std::ostream* ifaceOutStreamPtrIn);
 
 	public:
 		
 		Packet* getPacketPtr();
 		int		getTokenSize(); 
+		int		getTokenCapacity();
 		int		getPacketOption();
 		enum PacketTypes	getPacketType();
-		PacketInterface_ASCII(std::iostream* ifaceStreamPtrIn = nullptr);
-		PacketInterface_ASCII(std::istream* ifaceInStreamPtrIn);
-		PacketInterface_ASCII(std::ostream* ifaceOutStreamPtrIn);
 		/*! \fn DeSerializePacket_ASCII
 			\brief Default ASCII Deserialization
 			\sa Packet
@@ -146,12 +250,13 @@ namespace IMSPacketsAPICore
 			\param PcktInterface
 			\return True at Complete Packet Receiption, False otherwise
 
-			This static function is designed to be called cyclically on receipt of each
-			new character into the interface buffer.  On receipt, characters are analyzed for
-			token boundaries or errors.  If an error occurs, a reset is triggered.  Once the terminator
-			character is received, return true to trigger data execution instance handling.
+			This static function is designed to be called cyclically.  Characters are consumed from
+			the receive ring into the interface buffer and analyzed for token boundaries or errors.
+			If an error occurs, a reset is triggered.  Once the terminator character is received,
+			return true to trigger data execution instance handling, characters following the
+			terminator wait in the ring for the next call.
 		*/
-		static bool DeSerializePacket_ASCII(PacketInterface_ASCII* PcktInterface);
+		static bool DeSerializePacket_ASCII(PacketInterface_ASCIIBase* PcktInterface);
 		/*! \fn SerializePacket_ASCII
 			\brief Default ASCII Serialization
 			\sa SerializePacket
@@ -166,11 +271,26 @@ namespace IMSPacketsAPICore
 			It will then indicate success or failure which in-turn will permit, or not permit, the
 			interface instance writeto function.
 		*/
-		static bool SerializePacket_ASCII(PacketInterface_ASCII* PcktInterface);
-		static void WriteToStream_ASCII(PacketInterface_ASCII* PcktInterface, std::ostream* PcktInterfaceStream);
-		static void WriteToStream_ASCII(PacketInterface_ASCII* PcktInterface, std::iostream* PcktInterfaceStream);
-		static void ReadFromStream_ASCII(PacketInterface_ASCII* PcktInterface, std::istream* PcktInterfaceStream);
-		static void ReadFromStream_ASCII(PacketInterface_ASCII* PcktInterface, std::iostream* PcktInterfaceStream);
+		static bool SerializePacket_ASCII(PacketInterface_ASCIIBase* PcktInterface);
+		/*! \fn FramePackets_ASCII
+			\brief Batch Framing of a Contiguous Char Range
+			\sa DeSerializePackets
+			\param numCharsFramedPtr set to the count of chars framed or skipped, a partial packet at the end of the range is not
+			\return the number of complete packets found, at most maxFrames
+
+			Token boundaries are found, and token chars validated, 16 or 32 chars per compare
+			(Packet::scanTokenBoundary).  A frame spans a packet from its ID string through its terminator.
+			Framing restarts after a line break, an invalid char, a token too long for its slot, a packet of
+			more tokens than the interface buffer holds, or a terminator before the header tokens, as
+			DeSerializePacket_ASCII would reset on them.
+		*/
+		static int FramePackets_ASCII(PacketInterface_ASCIIBase* PcktInterface, const char* charsPtr, int numChars, struct PacketFrame* framesPtr, int maxFrames, int* numCharsFramedPtr);
+		//! FramePackets_ASCII for a buffer of TokenCapacity tokens, without an interface
+		static int FramePackets_ASCII(int TokenCapacity, const char* charsPtr, int numChars, struct PacketFrame* framesPtr, int maxFrames, int* numCharsFramedPtr);
+		static void WriteToStream_ASCII(PacketInterface_ASCIIBase* PcktInterface, std::ostream* PcktInterfaceStream);
+		static void WriteToStream_ASCII(PacketInterface_ASCIIBase* PcktInterface, std::iostream* PcktInterfaceStream);
+		static void ReadFromStream_ASCII(PacketInterface_ASCIIBase* PcktInterface, std::istream* PcktInterfaceStream);
+		static void ReadFromStream_ASCII(PacketInterface_ASCIIBase* PcktInterface, std::iostream* PcktInterfaceStream);
 		/*! \fn DeSerializePacket
 			\brief Default ASCII Deserialization
 			\sa DeSerializePacket_ASCII
@@ -180,14 +300,142 @@ namespace IMSPacketsAPICore
 		*/
 		bool DeSerializePacket();
 		bool SerializePacket();
+
+		/*! \fn DeSerializePackets
+			\brief Batch Deserialization of every Complete Packet at the Read Position of the Receive Ring
+			\sa FramePackets_ASCII
+			\return the number of frames, at most maxFrames
+
+			Frames locate packets relative to getFramesBuffer(), and are valid until the next ReadFrom.
+			SlotFramePacket places the tokens of a frame in the token slots of the interface buffer, then
+			the interface packet is handled as after DeSerializePacket.  When it returns 0 with chars still
+			in the ring, either a packet is partially assembled by, or wraps the ring and is left for,
+			DeSerializePacket.
+		*/
+		int			DeSerializePackets(struct PacketFrame* framesPtr, int maxFrames);
+		char*		getFramesBuffer();
+		bool		SlotFramePacket(const struct PacketFrame* framePtr);
+		//! Slots each frame in turn, skipping frames with a token too long for its slot
+		bool		DeSerializeFrame();
+
+		/*! \fn getEmitter
+			\brief A PacketEmitter over the interface buffer, for single pass transmit packaging
+
+			A packager emits the fields of a packet straight to the interface buffer, in wire order, then
+			passes the char count of finish() to EmittedPacket.  The next SerializePacket sends the
+			emitted packet as is, skipping the token slots and SerializePacket_ASCII.  The interface
+			packet then holds no token slots, so an emitted packet is for transmit-only paths.
+		*/
+		template<class Schema>
+		PacketEmitter<Schema>	getEmitter() { return PacketEmitter<Schema>(TokenChars, STRINGBUFFER_CHARCOUNT_OF(TokenCapacity)); }
+		//! Mark the interface buffer as serialized by an emitter, false if numChars is not a finished packet
+		bool		EmittedPacket(int numChars);
 	};
 	
 	
+	/*! \class PacketInterface_ASCIISized
+		\brief API Node ASCII Interface with a buffer of BufferTokenCapacity tokens
+	*/
+	template<int BufferTokenCapacity = PACKETBUFFER_TOKENCOUNT>
+	class PacketInterface_ASCIISized : public PacketInterface_ASCIIBase
+	{
+	protected:
+		SPDASCIIInterfaceBufferSized<BufferTokenCapacity>	TokenBuffer;
+
+	public:
+		PacketInterface_ASCIISized(std::iostream* ifaceStreamPtrIn = nullptr) :
+			PacketInterface_ASCIIBase(&TokenBuffer.chars[0], BufferTokenCapacity, ifaceStreamPtrIn) { ; }
+		PacketInterface_ASCIISized(std::istream* ifaceInStreamPtrIn) :
+			PacketInterface_ASCIIBase(&TokenBuffer.chars[0], BufferTokenCapacity, ifaceInStreamPtrIn) { ; }
+		PacketInterface_ASCIISized(std::ostream* ifaceOutStreamPtrIn) :
+			PacketInterface_ASCIIBase(&TokenBuffer.chars[0], BufferTokenCapacity, ifaceOutStreamPtrIn) { ; }
+	};
+
+	/*! \class PacketInterface_ASCII
+		\brief API Node ASCII Interface for HDR_Packets, with a buffer of the default capacity
+	*/
+	typedef PacketInterface_ASCIISized<PACKETBUFFER_TOKENCOUNT> PacketInterface_ASCII;
+
+	/*! \class PacketInterface_ASCIICompactBase
+		\brief API Node ASCII Receive Interface, packets kept in the receive ring as they were framed
+
+		The receive alternative to PacketInterface_ASCIIBase for nodes of many ASCII ports.  There is no
+		slotted token buffer: DeSerializePacket frames a packet in place in the receive ring, replaces its
+		delimiters and terminator with 0x00, and records a PacketTokenSpan per token.  The interface packet
+		is bound to the ring chars and the span table, so packet accessors, views, and registry dispatch
+		read its tokens through the table.  No chars are copied, padded, or zeroed.
+
+		The interface packet is valid until the next DeSerializePacket, and is read only.  The interface
+		is an input only, SerializePacket always fails.
+	*/
+	class PacketInterface_ASCIICompactBase : public PacketInterface
+	{
+	protected:
+		struct PacketTokenSpan*				TokenSpans = nullptr;
+		int									TokenCapacity = 0;
+		int									HeldChars = 0;		// ring chars of the interface packet, consumed at the next DeSerializePacket
+		Packet_HDRPACK						BufferPacket;
+
+		void WriteToStream();
+		void ReadFromStream();
+		void SpanFramePacket(char* frameCharsPtr, int frameLength);
+
+		PacketInterface_ASCIICompactBase(struct PacketTokenSpan* TokenSpansIn, int TokenCapacityIn, std::iostream* ifaceStreamPtrIn);
+		PacketInterface_ASCIICompactBase(struct PacketTokenSpan* TokenSpansIn, int TokenCapacityIn, std::istream* ifaceInStreamPtrIn);
+
+	public:
+		Packet* getPacketPtr();
+		int		getTokenSize();
+		int		getTokenCapacity();
+		int		getPacketOption();
+		enum PacketTypes	getPacketType();
+
+		/*! \fn DeSerializePacket
+			\brief Frame the next complete packet in the receive ring
+			\sa FramePackets_ASCII
+			\return True at Complete Packet Receiption, False otherwise
+
+			Framing restarts as FramePackets_ASCII does.  A packet that wraps the ring is made contiguous
+			first (PacketRxRing::Linearize).
+		*/
+		bool DeSerializePacket();
+		bool SerializePacket();
+		const struct PacketTokenSpan*	getTokenSpans();
+	};
+
+	/*! \class PacketInterface_ASCIICompactSized
+		\brief API Node ASCII Receive Interface with a span table of BufferTokenCapacity tokens
+	*/
+	template<int BufferTokenCapacity = PACKETBUFFER_TOKENCOUNT>
+	class PacketInterface_ASCIICompactSized : public PacketInterface_ASCIICompactBase
+	{
+		static_assert(BufferTokenCapacity >= 4, "token buffers hold at least the 4 header tokens");
+		static_assert(STRINGBUFFER_CHARCOUNT_OF(BufferTokenCapacity) < PACKETINTERFACE_RXRINGSIZE, "a packet of BufferTokenCapacity tokens must fit the receive ring");
+	protected:
+		struct PacketTokenSpan			SpansTable[BufferTokenCapacity];
+
+	public:
+		PacketInterface_ASCIICompactSized(std::iostream* ifaceStreamPtrIn = nullptr) :
+			PacketInterface_ASCIICompactBase(&SpansTable[0], BufferTokenCapacity, ifaceStreamPtrIn) { ; }
+		PacketInterface_ASCIICompactSized(std::istream* ifaceInStreamPtrIn) :
+			PacketInterface_ASCIICompactBase(&SpansTable[0], BufferTokenCapacity, ifaceInStreamPtrIn) { ; }
+	};
+
+	/*! \class PacketInterface_ASCIICompact
+		\brief API Node ASCII Receive Interface, with a span table of the default capacity
+	*/
+	typedef PacketInterface_ASCIICompactSized<PACKETBUFFER_TOKENCOUNT> PacketInterface_ASCIICompact;
+
+	
 	/*! \class API_NODE
 		\brief API Node for HDR_Packets
 	*/
+	class PortExecutor;
+	class PacketEventLoop;
 	class API_NODE :public AbstractDataExecution
 	{
+		friend class PortExecutor;
+		friend class PacketEventLoop;
 	protected:
 		virtual PolymorphicPacketPort* getPacketPortat(int i) = 0;
 		virtual int getNumPacketPorts() = 0;
@@ -211,6 +459,8 @@ namespace IMSPacketsAPICore
 		static void staticHandler_HDRPACK(Packet* PacketPtr, enum PacketTypes PackType, pSTRUCT(HDRPACK)* dstStruct);
 
 		static bool staticPackager_HDRPACK(Packet* PacketPtr, enum PacketTypes PackType, int PackOption);
+		//! Single pass alternative to staticPackager_HDRPACK, for ASCII transmit-only paths
+		static bool staticEmitter_HDRPACK(PacketInterface_ASCIIBase* PcktInterface, enum PacketTypes PackType, int PackOption);
 		
 	};
 	
@@ -0,0 +1,321 @@
+#include "3_PacketEventLoop.h"
+#include <unistd.h>			// read(), write(), close()
+#include <sys/epoll.h>		// epoll_create1(), epoll_ctl(), epoll_wait()
+#include <sys/eventfd.h>	// eventfd()
+#include <sys/timerfd.h>	// timerfd_create(), timerfd_settime()
+#include <cerrno>			// errno, EINTR
+using namespace IMSPacketsAPICore;
+
+// epoll data of the wake and timer descriptors, port events carry the port index and an output bit
+static constexpr uint64_t EventData_Wake = ~(uint64_t)0;
+static constexpr uint64_t EventData_Timer = ~(uint64_t)1;
+static constexpr int EventLoop_MaxEvents = 64;
+
+
+#pragma region PacketEventLoop Implementation
+PacketEventLoop::PacketEventLoop(API_NODE* NodePtrIn)
+{
+	NodePtr = NodePtrIn;
+	isStopRequested.store(false, std::memory_order_relaxed);
+
+	struct epoll_event loopEvent;
+	EpollFD = epoll_create1(EPOLL_CLOEXEC);
+	WakeFD = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	TimerFD = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+	if (!isValid())
+	{
+		LastError = errno;
+		return;
+	}
+	loopEvent.events = EPOLLIN;
+	loopEvent.data.u64 = EventData_Wake;
+	if (epoll_ctl(EpollFD, EPOLL_CTL_ADD, WakeFD, &loopEvent) != 0)
+		LastError = errno;
+	loopEvent.data.u64 = EventData_Timer;
+	if (epoll_ctl(EpollFD, EPOLL_CTL_ADD, TimerFD, &loopEvent) != 0)
+		LastError = errno;
+}
+PacketEventLoop::~PacketEventLoop()
+{
+	if (EpollFD >= 0)
+		close(EpollFD);
+	if (WakeFD >= 0)
+		close(WakeFD);
+	if (TimerFD >= 0)
+		close(TimerFD);
+}
+
+bool	PacketEventLoop::AddPort(PolymorphicPacketPort* PortPtr)
+{
+	if (PortPtr == nullptr || !isValid() || NumPorts >= PACKETEVENTLOOP_PORTCAPACITY)
+		return false;
+	for (int i = 0; i < NumPorts; i++)
+		if (Ports[i].PortPtr == PortPtr)
+			return false;
+
+	struct EventPort* EventPortPtr = &Ports[NumPorts];
+	EventPortPtr->PortPtr = PortPtr;
+	EventPortPtr->InputFD = (PortPtr->getInputInterface() != nullptr) ? PortPtr->getInputInterface()->getEventFD() : -1;
+	EventPortPtr->OutputFD = (PortPtr->getOutputInterface() != nullptr) ? PortPtr->getOutputInterface()->getEventFD() : -1;
+	if (EventPortPtr->OutputFD == EventPortPtr->InputFD)
+		EventPortPtr->OutputFD = -1;
+	EventPortPtr->isOutputArmed = false;
+	EventPortPtr->isReady = true;		// serviced once, to start its state machine
+	EventPortPtr->isOutputReady = false;
+	EventPortPtr->isInputWatched = false;
+	EventPortPtr->isOutputWatched = false;
+	EventPortPtr->isInputHungUp = false;
+	EventPortPtr->isOutputHungUp = false;
+	EventPortPtr->LastQueueDepth = 0;
+
+	// the input descriptor is watched for reads, an output descriptor of its own only when armed
+	struct epoll_event portEvent;
+	if (EventPortPtr->InputFD >= 0)
+	{
+		portEvent.events = EPOLLIN;
+		portEvent.data.u64 = (uint64_t)NumPorts << 1;
+		if (epoll_ctl(EpollFD, EPOLL_CTL_ADD, EventPortPtr->InputFD, &portEvent) != 0)
+		{
+			LastError = errno;
+			return false;
+		}
+		EventPortPtr->isInputWatched = true;
+	}
+	if (EventPortPtr->OutputFD >= 0)
+	{
+		portEvent.events = 0;
+		portEvent.data.u64 = ((uint64_t)NumPorts << 1) | 1u;
+		if (epoll_ctl(EpollFD, EPOLL_CTL_ADD, EventPortPtr->OutputFD, &portEvent) != 0)
+		{
+			LastError = errno;
+			if (EventPortPtr->InputFD >= 0)
+				epoll_ctl(EpollFD, EPOLL_CTL_DEL, EventPortPtr->InputFD, nullptr);
+			return false;
+		}
+		EventPortPtr->isOutputWatched = true;
+	}
+	NumPorts++;
+	return true;
+}
+int		PacketEventLoop::AddNodePorts()
+{
+	int numAdded = 0;
+	if (NodePtr != nullptr)
+		for (int i = 0; i < NodePtr->getNumPacketPorts(); i++)
+			if (NodePtr->getPacketPortat(i) != nullptr && !NodePtr->getPacketPortat(i)->getAsyncService() && AddPort(NodePtr->getPacketPortat(i)))
+				numAdded++;
+	return numAdded;
+}
+bool	PacketEventLoop::isInputWatched(PolymorphicPacketPort* PortPtr)
+{
+	for (int i = 0; i < NumPorts; i++)
+		if (Ports[i].PortPtr == PortPtr)
+			return Ports[i].isInputWatched;
+	return false;
+}
+
+bool	PacketEventLoop::setTimerMicros(int periodMicros)
+{
+	struct itimerspec timerSpec;
+	if (!isValid() || periodMicros < 0)
+		return false;
+	timerSpec.it_interval.tv_sec = periodMicros / 1000000;
+	timerSpec.it_interval.tv_nsec = (long)(periodMicros % 1000000) * 1000;
+	timerSpec.it_value = timerSpec.it_interval;
+	if (timerfd_settime(TimerFD, 0, &timerSpec, nullptr) != 0)
+	{
+		LastError = errno;
+		return false;
+	}
+	return true;
+}
+
+void	PacketEventLoop::Wake()
+{
+	uint64_t wakeCount = 1;
+	if (WakeFD >= 0 && write(WakeFD, &wakeCount, sizeof(wakeCount)) < 0)
+		LastError = errno;	// only fails if the count would overflow, the loop is already woken
+}
+
+bool	PacketEventLoop::ArmOutput(struct EventPort* EventPortPtr, bool isArmed)
+{
+	if (EventPortPtr->isOutputArmed == isArmed)
+		return true;
+
+	// a shared descriptor keeps its read events
+	struct epoll_event portEvent;
+	int eventFD = (EventPortPtr->OutputFD >= 0) ? EventPortPtr->OutputFD : EventPortPtr->InputFD;
+	bool isWatched = (EventPortPtr->OutputFD >= 0) ? EventPortPtr->isOutputWatched : EventPortPtr->isInputWatched;
+	if (eventFD < 0 || !isWatched)
+		return false;
+	uint32_t outEvents = isArmed ? (uint32_t)EPOLLOUT : 0u;
+	uint32_t inEvents = (EventPortPtr->OutputFD >= 0) ? 0u : (uint32_t)EPOLLIN;
+	portEvent.events = outEvents | inEvents;
+	portEvent.data.u64 = ((uint64_t)(EventPortPtr - Ports) << 1) | ((EventPortPtr->OutputFD >= 0) ? 1u : 0u);
+	if (epoll_ctl(EpollFD, EPOLL_CTL_MOD, eventFD, &portEvent) != 0)
+	{
+		LastError = errno;
+		return false;
+	}
+	EventPortPtr->isOutputArmed = isArmed;
+	return true;
+}
+
+// flush the output interfaces past their deadline, returns the micros to the earliest remaining deadline, -1 if none
+int		PacketEventLoop::FlushOverdueOutput()
+{
+	int earliestMicros = -1;
+	for (int i = 0; i < NumPorts; i++)
+	{
+		PacketInterface* OutputPtr = Ports[i].PortPtr->getOutputInterface();
+		if (OutputPtr == nullptr)
+			continue;
+		int deadlineMicros = OutputPtr->getOutputDeadlineMicros();
+		if (deadlineMicros == 0)
+		{
+			OutputPtr->FlushTo();
+			ArmOutput(&Ports[i], OutputPtr->isOutputBlocked());
+		}
+		else if (deadlineMicros > 0 && (earliestMicros < 0 || deadlineMicros < earliestMicros))
+			earliestMicros = deadlineMicros;
+	}
+	return earliestMicros;
+}
+
+// hang ups and errors stay reported, level triggered, until the descriptor is removed from the epoll set
+void	PacketEventLoop::UnwatchInput(struct EventPort* EventPortPtr)
+{
+	if (!EventPortPtr->isInputWatched)
+		return;
+	if (epoll_ctl(EpollFD, EPOLL_CTL_DEL, EventPortPtr->InputFD, nullptr) != 0)
+		LastError = errno;
+	EventPortPtr->isInputWatched = false;
+	if (EventPortPtr->OutputFD < 0)
+		EventPortPtr->isOutputArmed = false;
+}
+void	PacketEventLoop::UnwatchOutput(struct EventPort* EventPortPtr)
+{
+	if (!EventPortPtr->isOutputWatched)
+		return;
+	if (epoll_ctl(EpollFD, EPOLL_CTL_DEL, EventPortPtr->OutputFD, nullptr) != 0)
+		LastError = errno;
+	EventPortPtr->isOutputWatched = false;
+	EventPortPtr->isOutputArmed = false;
+}
+
+void	PacketEventLoop::ServiceEventPort(struct EventPort* EventPortPtr)
+{
+	PolymorphicPacketPort* PortPtr = EventPortPtr->PortPtr;
+	PacketInterface* OutputPtr = PortPtr->getOutputInterface();
+	PacketInterface* InputPtr = PortPtr->getInputInterface();
+
+	if (EventPortPtr->isOutputReady && OutputPtr != nullptr)
+		OutputPtr->FlushTo();
+	int queueDepth = PortPtr->getOutPackQueueDepth();
+	PortPtr->ServicePort();
+
+	// bytes left in the ring do not make the descriptor readable again, nor does a queue being drained
+	EventPortPtr->LastQueueDepth = PortPtr->getOutPackQueueDepth();
+	EventPortPtr->isReady = (InputPtr != nullptr && InputPtr->isInputPending())
+		|| (EventPortPtr->LastQueueDepth > 0 && EventPortPtr->LastQueueDepth != queueDepth);
+	EventPortPtr->isOutputReady = false;
+
+	// the last bytes of a closed input were read by this service, a shared descriptor goes with its input
+	if (EventPortPtr->isInputHungUp || (InputPtr != nullptr && InputPtr->isInputClosed()))
+		UnwatchInput(EventPortPtr);
+	if (EventPortPtr->isOutputHungUp)
+		UnwatchOutput(EventPortPtr);
+	ArmOutput(EventPortPtr, (OutputPtr != nullptr && OutputPtr->isOutputBlocked()));
+}
+
+int		PacketEventLoop::RunOnce(int timeoutMillis)
+{
+	struct epoll_event loopEvents[EventLoop_MaxEvents];
+	uint64_t expiryCount;
+	bool isTimerExpired = false;
+	bool isWoken = false;
+	int numServiced = 0;
+
+	// packets enqueued since a port was serviced, or bytes left in its ring, do not wait
+	for (int i = 0; i < NumPorts; i++)
+		if (!Ports[i].isReady && Ports[i].PortPtr->getOutPackQueueDepth() != Ports[i].LastQueueDepth)
+			Ports[i].isReady = true;
+	for (int i = 0; i < NumPorts; i++)
+		if (Ports[i].isReady)
+		{
+			timeoutMillis = 0;
+			break;
+		}
+	int deadlineMicros = FlushOverdueOutput();
+	if (deadlineMicros >= 0 && (timeoutMillis < 0 || timeoutMillis > (deadlineMicros + 999) / 1000))
+		timeoutMillis = (deadlineMicros + 999) / 1000;
+
+	int numEvents = epoll_wait(EpollFD, loopEvents, EventLoop_MaxEvents, timeoutMillis);
+	if (numEvents < 0)
+	{
+		if (errno != EINTR)
+		{
+			LastError = errno;
+			return -1;
+		}
+		numEvents = 0;
+	}
+	FlushOverdueOutput();
+
+	for (int i = 0; i < numEvents; i++)
+	{
+		if (loopEvents[i].data.u64 == EventData_Wake)
+		{
+			if (read(WakeFD, &expiryCount, sizeof(expiryCount)) > 0)
+				isWoken = true;
+		}
+		else if (loopEvents[i].data.u64 == EventData_Timer)
+		{
+			if (read(TimerFD, &expiryCount, sizeof(expiryCount)) > 0)
+				isTimerExpired = true;
+		}
+		else
+		{
+			struct EventPort* EventPortPtr = &Ports[loopEvents[i].data.u64 >> 1];
+			if (loopEvents[i].events & EPOLLOUT)
+				EventPortPtr->isOutputReady = true;
+			if ((loopEvents[i].events & (EPOLLERR | EPOLLHUP)) && (loopEvents[i].data.u64 & 1u))
+				EventPortPtr->isOutputHungUp = true;
+			else if (loopEvents[i].events & (EPOLLERR | EPOLLHUP))
+				EventPortPtr->isInputHungUp = true;
+			// errors and hang ups are serviced as reads, the interface sees them there
+			if (loopEvents[i].events & (EPOLLIN | EPOLLOUT | EPOLLERR | EPOLLHUP))
+				EventPortPtr->isReady = true;
+		}
+	}
+
+	for (int i = 0; i < NumPorts; i++)
+	{
+		bool isPortReady = Ports[i].isReady || isTimerExpired
+			|| (isWoken && Ports[i].InputFD < 0 && Ports[i].OutputFD < 0)
+			|| (isWoken && Ports[i].PortPtr->getOutPackQueueDepth() != Ports[i].LastQueueDepth);
+		if (isPortReady)
+		{
+			ServiceEventPort(&Ports[i]);
+			numServiced++;
+		}
+	}
+
+	if (NodePtr != nullptr)
+		NodePtr->CustomLoop();
+	return numServiced;
+}
+
+void	PacketEventLoop::Run()
+{
+	while (!isStopRequested.load(std::memory_order_acquire))
+		if (RunOnce(-1) < 0)
+			break;
+	isStopRequested.store(false, std::memory_order_release);
+}
+void	PacketEventLoop::Stop()
+{
+	isStopRequested.store(true, std::memory_order_release);
+	Wake();
+}
+#pragma endregion
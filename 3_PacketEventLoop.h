@@ -0,0 +1,114 @@
+/*! \file 3_PacketEventLoop.h
+	\brief Event Driven Service of Packet Ports over File Descriptors
+	\sa APINodeLink
+
+	For nodes with a Linux platform layer (epoll, eventfd, and timerfd).  API_NODE::Loop polls every
+	synchronous port every cycle, as bare-metal nodes must.  A PacketEventLoop blocks until a port has
+	something to do, then services only that port.
+*/
+#ifndef __PACKETEVENTLOOP__
+#define __PACKETEVENTLOOP__
+#include "3_PacketInterface_POSIX.h"
+
+namespace IMSPacketsAPICore
+{
+	/*! \addtogroup APINodeLink
+		@{
+	*/
+
+	/*! \class PacketEventLoop
+		\brief Services packet ports when their descriptors are ready, their queues change, or a timer expires
+
+		A port is serviced when
+		- the descriptor of its input interface is readable, or bytes remain in its receive ring,
+		- the descriptor of its output interface is writable while a write is partially complete,
+		  its staged output is then flushed first,
+		- the depth of its output queue has changed since it was last serviced, or was changed by
+		  its last service, so a port draining its queue is serviced until it stops, or
+		- the timer expires, when every port is serviced, e.g. for the resets of waiting state machines.
+		Staged output is flushed when its MaxStagedMicros deadline passes, before and after each wait,
+		and no wait outlasts the earliest deadline of the output interfaces.
+		Interfaces report their descriptor by getEventFD(), ports with no descriptor are serviced only
+		on wakes and timer expiries.  A descriptor that hangs up, errs, or whose input reaches end of file
+		is serviced once more and then no longer watched, its port is still serviced while bytes remain
+		in its ring, on wakes, and on timer expiries.
+
+		Packets enqueued on the loop thread, by handlers or the node, are seen before the next wait.
+		Threads enqueuing to a port call Wake() after, to end a wait.  They enqueue concurrently with
+		the handlers of the port, so its lanes must be multi-producer, as the default lanes are.  Each RunOnce() calls the
+		CustomLoop() of the node, if one is given, after servicing the ready ports.
+	*/
+	class PacketEventLoop
+	{
+	protected:
+		struct EventPort
+		{
+			PolymorphicPacketPort*	PortPtr;
+			int						InputFD;
+			int						OutputFD;			// -1 if it is the input descriptor or none
+			bool					isOutputArmed;		// waiting for the output descriptor to be writable
+			bool					isReady;
+			bool					isOutputReady;
+			bool					isInputWatched;
+			bool					isOutputWatched;	// an output descriptor of its own
+			bool					isInputHungUp;		// hung up or erred, unwatched once serviced
+			bool					isOutputHungUp;
+			int						LastQueueDepth;
+		};
+
+		API_NODE*				NodePtr;
+		int						EpollFD		= -1;
+		int						WakeFD		= -1;
+		int						TimerFD		= -1;
+		struct EventPort		Ports[PACKETEVENTLOOP_PORTCAPACITY];
+		int						NumPorts	= 0;
+		std::atomic<bool>		isStopRequested;
+		int						LastError	= 0;
+
+		bool			ArmOutput(struct EventPort* EventPortPtr, bool isArmed);
+		int				FlushOverdueOutput();
+		void			UnwatchInput(struct EventPort* EventPortPtr);
+		void			UnwatchOutput(struct EventPort* EventPortPtr);
+		void			ServiceEventPort(struct EventPort* EventPortPtr);
+
+	public:
+		//! An event loop of a node, whose CustomLoop() it calls, or of ports only if NodePtrIn is nullptr
+		PacketEventLoop(API_NODE* NodePtrIn = nullptr);
+		~PacketEventLoop();
+		PacketEventLoop(const PacketEventLoop&) = delete;
+		PacketEventLoop& operator=(const PacketEventLoop&) = delete;
+
+		//! The epoll, wake, and timer descriptors were created
+		inline bool		isValid() { return (EpollFD >= 0 && WakeFD >= 0 && TimerFD >= 0); }
+		inline int		getLastError() { return LastError; }
+
+		//! Service a port by events, false if it was added, the loop is full, or its descriptors can not be watched
+		bool			AddPort(PolymorphicPacketPort* PortPtr);
+		//! Add every synchronous port of the node, \return the number added
+		int				AddNodePorts();
+		//! The input descriptor of a port is still watched, false once it hung up or closed, or if it has none
+		bool			isInputWatched(PolymorphicPacketPort* PortPtr);
+
+		//! Expire the timer every periodMicros, 0 (the default) disarms it
+		bool			setTimerMicros(int periodMicros);
+
+		//! End a wait of the loop, from any thread
+		void			Wake();
+
+		/*! \fn RunOnce
+			\brief Wait up to timeoutMillis (-1 indefinitely) for ready ports, then service them
+
+			The wait ends early at the earliest flush deadline of staged output.
+			\return The number of ports serviced, -1 if the wait failed
+		*/
+		int				RunOnce(int timeoutMillis = -1);
+		//! RunOnce until Stop()
+		void			Run();
+		//! End Run() after its current RunOnce, from any thread
+		void			Stop();
+	};
+
+	/*! @}*/
+}
+
+#endif // !__PACKETEVENTLOOP__
@@ -0,0 +1,271 @@
+#include "3_PacketInterface_POSIX.h"
+#include <unistd.h>		// read()
+#include <fcntl.h>		// fcntl(), O_NONBLOCK, open()
+#include <sys/mman.h>	// mmap(), munmap(), madvise()
+#include <sys/stat.h>	// fstat()
+#include <sys/uio.h>	// writev(), struct iovec
+#include <time.h>		// clock_gettime(), CLOCK_MONOTONIC
+#include <cerrno>		// errno, EAGAIN, EWOULDBLOCK, EINTR
+using namespace IMSPacketsAPICore;
+
+
+#pragma region PacketFDLink Implementation
+PacketFDLink::PacketFDLink(int FDIn, uint8_t* StageBytesIn, int StageCapacityIn)
+{
+	FD = FDIn;
+	StageBytes = StageBytesIn;
+	StageCapacity = StageCapacityIn;
+	setNonBlocking();
+}
+
+uint64_t	PacketFDLink::getMonotonicMicros()
+{
+	struct timespec nowTime;
+	clock_gettime(CLOCK_MONOTONIC, &nowTime);
+	return (uint64_t)nowTime.tv_sec * 1000000u + (uint64_t)nowTime.tv_nsec / 1000u;
+}
+
+bool	PacketFDLink::setNonBlocking()
+{
+	int fdFlags;
+	if (FD < 0)
+		return false;
+	fdFlags = fcntl(FD, F_GETFL, 0);
+	if (fdFlags < 0 || fcntl(FD, F_SETFL, fdFlags | O_NONBLOCK) < 0)
+	{
+		LastError = errno;
+		return false;
+	}
+	return true;
+}
+
+int		PacketFDLink::ReadToRing(PacketRxRing* RxRingPtr)
+{
+	int numRead = 0;
+	if (FD < 0 || RxRingPtr == nullptr)
+		return 0;
+
+	// at most two contiguous spans, a short read means the descriptor is drained
+	while (RxRingPtr->getSpace() > 0)
+	{
+		int spanSpace = RxRingPtr->getContiguousSpace();
+		ssize_t spanBytes = read(FD, RxRingPtr->getWritePtr(), spanSpace);
+		if (spanBytes > 0)
+		{
+			RxRingPtr->CommitWrite((int)spanBytes);
+			numRead += (int)spanBytes;
+			if (spanBytes < spanSpace)
+				break;
+		}
+		else if (spanBytes == 0)
+		{
+			isEndOfFile = true;
+			break;
+		}
+		else if (errno != EINTR)
+		{
+			if (errno != EAGAIN && errno != EWOULDBLOCK)
+				LastError = errno;
+			break;
+		}
+	}
+	return numRead;
+}
+
+// staged bytes then new bytes, gathered, until done or the descriptor would block
+// returns the count of new bytes written, new bytes are written only once no bytes are staged
+int		PacketFDLink::WriteGathered(const uint8_t* bytesPtr, int numBytes)
+{
+	int numWritten = 0;
+	while (StageCount > 0 || numWritten < numBytes)
+	{
+		struct iovec writeSpans[2];
+		int numSpans = 0;
+		if (StageCount > 0)
+		{
+			writeSpans[numSpans].iov_base = StageBytes + StageOffset;
+			writeSpans[numSpans++].iov_len = StageCount;
+		}
+		if (numWritten < numBytes)
+		{
+			writeSpans[numSpans].iov_base = (void*)(bytesPtr + numWritten);
+			writeSpans[numSpans++].iov_len = numBytes - numWritten;
+		}
+
+		ssize_t spanBytes = writev(FD, writeSpans, numSpans);
+		if (spanBytes < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			if (errno != EAGAIN && errno != EWOULDBLOCK)
+				LastError = errno;
+			break;
+		}
+
+		int stagedWritten = ((int)spanBytes < StageCount) ? (int)spanBytes : StageCount;
+		StageOffset += stagedWritten;
+		StageCount -= stagedWritten;
+		numWritten += (int)spanBytes - stagedWritten;
+		if (StageCount == 0)
+			StageOffset = 0;
+	}
+	return numWritten;
+}
+
+// append to the staged bytes, compacting them if needed, false if they do not fit
+bool	PacketFDLink::StageBytesAt(const uint8_t* bytesPtr, int numBytes)
+{
+	if (StageOffset + StageCount + numBytes > StageCapacity)
+	{
+		memmove(StageBytes, StageBytes + StageOffset, StageCount);
+		StageOffset = 0;
+	}
+	if (StageCount + numBytes > StageCapacity)
+		return false;
+	memcpy(StageBytes + StageOffset + StageCount, bytesPtr, numBytes);
+	StageCount += numBytes;
+	return true;
+}
+
+bool	PacketFDLink::Write(const uint8_t* bytesPtr, int numBytes)
+{
+	int numWritten;
+	if (FD < 0 || bytesPtr == nullptr || numBytes < 0)
+		return false;
+
+	// stage while the policy allows, no write is partially complete, and the deadline has not passed
+	if (!isFlushing && StagedPackets + 1 < FlushPolicy.MaxStagedPackets && StageCount + numBytes < FlushPolicy.MaxStagedBytes
+		&& !isDeadlinePassed() && StageBytesAt(bytesPtr, numBytes))
+	{
+		if (StagedPackets++ == 0)
+			StageMicros = getMonotonicMicros();
+		return true;
+	}
+
+	// the staged packets and this packet, in one gathered write
+	// keep what the descriptor does not take, or drop the packet whole if none of it was written and it does not fit
+	numWritten = WriteGathered(bytesPtr, numBytes);
+	StagedPackets = 0;
+	if (numWritten < numBytes && !StageBytesAt(bytesPtr + numWritten, numBytes - numWritten))
+	{
+		DroppedCount++;
+		isFlushing = (StageCount > 0);
+		return false;
+	}
+	isFlushing = (StageCount > 0);
+	return true;
+}
+
+bool	PacketFDLink::Flush()
+{
+	if (StageCount == 0)
+		return true;
+	if (FD >= 0)
+		WriteGathered(nullptr, 0);
+	StagedPackets = 0;
+	isFlushing = (StageCount > 0);
+	return (StageCount == 0);
+}
+
+void	PacketFDLink::ServiceFlush()
+{
+	if (StageCount == 0)
+		return;
+	if (isFlushing || isDeadlinePassed())
+		Flush();
+}
+
+bool	PacketFDLink::isDeadlinePassed()
+{
+	return (StagedPackets > 0 && FlushPolicy.MaxStagedMicros > 0 && getMonotonicMicros() - StageMicros >= (uint64_t)FlushPolicy.MaxStagedMicros);
+}
+
+int		PacketFDLink::getFlushDeadlineMicros()
+{
+	// a partially complete write waits on the descriptor, not the deadline
+	if (isFlushing || StagedPackets == 0 || FlushPolicy.MaxStagedMicros <= 0)
+		return -1;
+	uint64_t stagedMicros = getMonotonicMicros() - StageMicros;
+	return (stagedMicros >= (uint64_t)FlushPolicy.MaxStagedMicros) ? 0 : FlushPolicy.MaxStagedMicros - (int)stagedMicros;
+}
+
+void	PacketFDLink::setFlushPolicy(struct PacketFlushPolicy FlushPolicyIn)
+{
+	FlushPolicy = FlushPolicyIn;
+	if (FlushPolicy.MaxStagedPackets < 1)
+		FlushPolicy.MaxStagedPackets = 1;
+}
+void	PacketFDLink::setImmediate()
+{
+	struct PacketFlushPolicy ImmediatePolicy = { 0, 1, 0 };
+	FlushPolicy = ImmediatePolicy;
+	Flush();
+}
+struct PacketFlushPolicy	PacketFDLink::getFlushPolicy() { return FlushPolicy; }
+#pragma endregion
+
+#pragma region PacketFileMap Implementation
+
+// consumed bytes are released from memory in spans of at least this size
+#define PACKETFILEMAP_RELEASEBYTES (16 * 1024 * 1024)
+
+PacketFileMap::PacketFileMap(const char* filePath)
+{
+	struct stat fileStat;
+	void* mapPtr;
+	int fileFD = (filePath != nullptr) ? open(filePath, O_RDONLY) : -1;
+	if (fileFD < 0)
+	{
+		LastError = errno;
+		return;
+	}
+	if (fstat(fileFD, &fileStat) < 0 || fileStat.st_size <= 0)
+	{
+		LastError = errno;
+		close(fileFD);
+		return;
+	}
+
+	// private pages, written only by in place byte order conversion, never to the file
+	mapPtr = mmap(nullptr, (size_t)fileStat.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fileFD, 0);
+	if (mapPtr == MAP_FAILED)
+		LastError = errno;
+	else
+	{
+		MapBytes = (uint8_t*)mapPtr;
+		MapSize = (size_t)fileStat.st_size;
+		madvise(MapBytes, MapSize, MADV_SEQUENTIAL);
+	}
+	close(fileFD);
+}
+
+PacketFileMap::~PacketFileMap()
+{
+	if (MapBytes != nullptr)
+		munmap(MapBytes, MapSize);
+}
+
+void	PacketFileMap::Consume(int numBytes)
+{
+	// the packet last framed starts at or after the read position, pages before it are done
+	size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+	size_t releaseEnd = ReadOffset - (ReadOffset % pageSize);
+	if (releaseEnd - ReleasedOffset >= PACKETFILEMAP_RELEASEBYTES)
+	{
+		madvise(MapBytes + ReleasedOffset, releaseEnd - ReleasedOffset, MADV_DONTNEED);
+		ReleasedOffset = releaseEnd;
+	}
+	ReadOffset += (size_t)numBytes;
+	if (ReadOffset > MapSize)
+		ReadOffset = MapSize;
+}
+
+void	PacketFileMap::Rewind()
+{
+	// pages converted in place are discarded, all pages are read from the file again
+	if (MapBytes != nullptr)
+		madvise(MapBytes, MapSize, MADV_DONTNEED);
+	ReadOffset = 0;
+	ReleasedOffset = 0;
+}
+#pragma endregion
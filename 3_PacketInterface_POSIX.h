@@ -0,0 +1,285 @@
+/*! \file 3_PacketInterface_POSIX.h
+	\brief Packet Interfaces over POSIX File Descriptors
+	\sa APINodeLink
+
+	For nodes with a POSIX platform layer.  Pipes, socketpairs, ttys, and sockets are read and
+	written directly, without a stream library between the driver and the interface buffers.
+*/
+#ifndef __PACKETINTERFACEPOSIX__
+#define __PACKETINTERFACEPOSIX__
+#include "3_APINodeLink.h"
+#include <climits>		// INT_MAX
+
+namespace IMSPacketsAPICore
+{
+	/*! \addtogroup APINodeLink
+		@{
+	*/
+
+	/*! \struct PacketFlushPolicy
+		\brief When the staged output of an interface is written
+
+		Serialized packets are staged until one more would reach MaxStagedBytes or MaxStagedPackets,
+		then the staged packets and that packet are written together.  Staged packets older than
+		MaxStagedMicros are written at the next service, write, or flush of the interface, 0 disables the
+		deadline.  An interface that is only an output is not serviced by its port, so a node calls its
+		FlushTo() when it must not wait for the next packet.  A MaxStagedPackets of 1 writes every packet
+		immediately.
+	*/
+	struct PacketFlushPolicy
+	{
+		int		MaxStagedBytes;
+		int		MaxStagedPackets;
+		int		MaxStagedMicros;
+	};
+
+	/*! \class PacketFDLink
+		\brief Non-blocking reads and coalesced writes of a file descriptor for a packet interface
+
+		Reads take everything available, up to the free space of a receive ring, until the descriptor
+		would block.  Writes never block: serialized packets are staged according to the flush policy,
+		then the staged bytes and the packet completing the stage go out in one gathered write (writev).
+		Bytes the descriptor does not take stay staged and are written ahead of any later bytes, at the
+		next service, write, or flush.  Writes that fit neither the descriptor nor the stage are dropped
+		whole, and counted.
+
+		The stage is allocated by the owning interface.  The descriptor is set non-blocking at
+		construction, but is not owned, it is neither opened nor closed by the link.  Writes to a
+		closed pipe or socket raise SIGPIPE, which a node ignores to see EPIPE from getLastError().
+	*/
+	class PacketFDLink
+	{
+	protected:
+		int			FD;
+		uint8_t*	StageBytes;
+		int			StageCapacity;
+		int			StageOffset		= 0;	// first unwritten staged byte
+		int			StageCount		= 0;	// bytes staged, from StageOffset
+		int			StagedPackets	= 0;
+		uint64_t	StageMicros		= 0;	// time the first staged packet was staged
+		bool		isFlushing		= false;// a write is partially complete
+		struct PacketFlushPolicy	FlushPolicy = { 0, 1, 0 };
+		int			LastError		= 0;	// errno of the last failed call, other than EAGAIN/EINTR
+		bool		isEndOfFile		= false;
+		int			DroppedCount	= 0;
+
+		static uint64_t	getMonotonicMicros();
+		int			WriteGathered(const uint8_t* bytesPtr, int numBytes);
+		bool		StageBytesAt(const uint8_t* bytesPtr, int numBytes);
+		bool		isDeadlinePassed();
+
+	public:
+		PacketFDLink(int FDIn, uint8_t* StageBytesIn, int StageCapacityIn);
+
+		//! Set O_NONBLOCK on the descriptor, true on success
+		bool		setNonBlocking();
+
+		/*! \fn ReadToRing
+			\brief Read until the descriptor would block, the ring is full, or end of file
+			\return The number of bytes read
+		*/
+		int			ReadToRing(PacketRxRing* RxRingPtr);
+
+		/*! \fn Write
+			\brief Stage or write a serialized packet, after any staged bytes
+			\return False if the packet was dropped
+		*/
+		bool		Write(const uint8_t* bytesPtr, int numBytes);
+		//! Write all staged bytes now, true once nothing is staged
+		bool		Flush();
+		//! Continue a partial write, or flush staged packets past their deadline
+		void		ServiceFlush();
+
+		void		setFlushPolicy(struct PacketFlushPolicy FlushPolicyIn);
+		//! Write every packet as it is serialized, the default
+		void		setImmediate();
+		struct PacketFlushPolicy	getFlushPolicy();
+
+		inline int	getFD() { return FD; }
+		inline bool	isWritePending() { return (StageCount > 0); }
+		//! A write is partially complete, the rest waits for the descriptor to be writable
+		inline bool	isWriteBlocked() { return isFlushing; }
+		inline bool	isClosed() { return isEndOfFile; }
+		//! Microseconds until the staged packets are past MaxStagedMicros, 0 if they are, -1 if none wait on it
+		int			getFlushDeadlineMicros();
+		inline int	getLastError() { return LastError; }
+		inline int	getDroppedCount() { return DroppedCount; }
+	};
+
+	/*! \class PacketInterface_BinaryFD
+		\brief Binary interface over a file descriptor
+
+		A drop-in PacketInterface_Binary, ports and nodes service it unchanged.  Reads fill the receive
+		ring through CustomReadFrom, which also services the staged output when one interface is both the
+		input and the output of a port.  Output is written immediately unless a flush policy is set.
+	*/
+	template<class TokenType, int TokenCapacity = PACKETBUFFER_TOKENCOUNT>
+	class PacketInterface_BinaryFD : public PacketInterface_Binary<TokenType, TokenCapacity>
+	{
+	protected:
+		uint8_t			StageBytes[PACKETINTERFACE_TXSTAGESIZE + TokenCapacity * sizeof(TokenType) + PacketInterface_Binary<TokenType, TokenCapacity>::FrameCheckBytes];
+		PacketFDLink	FDLink;
+
+		void	CustomReadFrom() { FDLink.ServiceFlush(); FDLink.ReadToRing(&this->RxRing); }
+		void	CustomFlushTo() { FDLink.Flush(); }
+		void	CustomWriteTo() { FDLink.Write(&this->TokenBuffer.bytes[0], this->serializedPacketSize); }
+
+	public:
+		PacketInterface_BinaryFD(int FDIn) :
+			PacketInterface_Binary<TokenType, TokenCapacity>((std::iostream*)nullptr), FDLink(FDIn, &StageBytes[0], sizeof(StageBytes)) { ; }
+
+		PacketFDLink*	getFDLink() { return &FDLink; }
+		int				getEventFD() { return FDLink.getFD(); }
+		bool			isOutputBlocked() { return FDLink.isWriteBlocked(); }
+		bool			isInputClosed() { return FDLink.isClosed(); }
+		int				getOutputDeadlineMicros() { return FDLink.getFlushDeadlineMicros(); }
+	};
+
+	/*! \class PacketInterface_ASCIIFD
+		\brief ASCII interface over a file descriptor, with a buffer of BufferTokenCapacity tokens
+
+		A drop-in PacketInterface_ASCIISized, as PacketInterface_BinaryFD is for binary interfaces.
+	*/
+	template<int BufferTokenCapacity = PACKETBUFFER_TOKENCOUNT>
+	class PacketInterface_ASCIIFD : public PacketInterface_ASCIISized<BufferTokenCapacity>
+	{
+	protected:
+		uint8_t			StageBytes[PACKETINTERFACE_TXSTAGESIZE + STRINGBUFFER_CHARCOUNT_OF(BufferTokenCapacity)];
+		PacketFDLink	FDLink;
+
+		void	CustomReadFrom() { FDLink.ServiceFlush(); FDLink.ReadToRing(&this->RxRing); }
+		void	CustomFlushTo() { FDLink.Flush(); }
+		void	CustomWriteTo() { FDLink.Write((const uint8_t*)this->TokenChars, this->serializedPacketSize); }
+
+	public:
+		PacketInterface_ASCIIFD(int FDIn) :
+			PacketInterface_ASCIISized<BufferTokenCapacity>((std::iostream*)nullptr), FDLink(FDIn, &StageBytes[0], sizeof(StageBytes)) { ; }
+
+		PacketFDLink*	getFDLink() { return &FDLink; }
+		int				getEventFD() { return FDLink.getFD(); }
+		bool			isOutputBlocked() { return FDLink.isWriteBlocked(); }
+		bool			isInputClosed() { return FDLink.isClosed(); }
+		int				getOutputDeadlineMicros() { return FDLink.getFlushDeadlineMicros(); }
+	};
+
+	/*! \class PacketFileMap
+		\brief A recorded packet file, mapped for sequential replay
+
+		The file is mapped private and writable, so packets are framed and converted to host byte
+		order in place without changing the file.  The kernel reads ahead of the read position
+		(MADV_SEQUENTIAL), and pages well behind it are released as it advances, so files larger
+		than memory replay in a bounded resident size.
+	*/
+	class PacketFileMap
+	{
+	protected:
+		uint8_t*	MapBytes		= nullptr;
+		size_t		MapSize			= 0;
+		size_t		ReadOffset		= 0;
+		size_t		ReleasedOffset	= 0;	// pages before it are released
+		int			LastError		= 0;
+
+	public:
+		PacketFileMap(const char* filePath);
+		~PacketFileMap();
+		PacketFileMap(const PacketFileMap&) = delete;
+		PacketFileMap& operator=(const PacketFileMap&) = delete;
+
+		inline bool		isMapped() { return (MapBytes != nullptr); }
+		inline uint8_t*	getReadPtr() { return MapBytes + ReadOffset; }
+		//! Bytes from the read position, at most INT_MAX per framing pass
+		inline int		getReadCount() { return (MapSize - ReadOffset > (size_t)INT_MAX) ? INT_MAX : (int)(MapSize - ReadOffset); }
+		inline size_t	getReadOffset() { return ReadOffset; }
+		inline size_t	getSize() { return MapSize; }
+		inline int		getLastError() { return LastError; }
+
+		/*! \fn Consume
+			\brief Advance the read position, pages before the previous read position may be released
+		*/
+		void			Consume(int numBytes);
+		void			Rewind();
+	};
+
+	/*! \class PacketInterface_BinaryMap
+		\brief Binary replay interface over a mapped packet file, for a PacketPort_FileSystem
+
+		Each DeSerializePacket frames the next packet in the mapping (FramePackets_Binary) and binds the
+		interface packet to it, so HandleRxPacket reads the packet in place, no copy and no read call.
+		The interface packet is valid until the next DeSerializePacket.
+	*/
+	template<class TokenType, int TokenCapacity = PACKETBUFFER_TOKENCOUNT>
+	class PacketInterface_BinaryMap : public PacketInterface_Binary<TokenType, TokenCapacity>
+	{
+	protected:
+		PacketFileMap	FileMap;
+
+	public:
+		PacketInterface_BinaryMap(const char* filePath) :
+			PacketInterface_Binary<TokenType, TokenCapacity>((std::istream*)nullptr), FileMap(filePath) { ; }
+
+		bool DeSerializePacket()
+		{
+			struct PacketFrame rxFrame;
+			int numBytesFramed;
+			while (FileMap.getReadCount() > 0)
+			{
+				// bytes before a partial packet at the end of the file are skipped as not packets
+				if (this->FramePackets_Binary(this, FileMap.getReadPtr(), FileMap.getReadCount(), &rxFrame, 1, &numBytesFramed) == 0)
+				{
+					FileMap.Consume(numBytesFramed);
+					if (numBytesFramed == 0)
+						return false;
+					continue;
+				}
+				this->BufferPacket.setBytesBuffer(FileMap.getReadPtr() + rxFrame.Offset, rxFrame.Length, sizeof(TokenType));
+				FileMap.Consume(numBytesFramed);
+				return true;
+			}
+			return false;
+		}
+		PacketFileMap*	getFileMap() { return &FileMap; }
+	};
+
+	/*! \class PacketInterface_ASCIIMap
+		\brief ASCII replay interface over a mapped packet file, for a PacketPort_FileSystem
+
+		Each DeSerializePacket frames the next packet in the mapping (FramePackets_ASCII) and places its
+		tokens in the token slots of the interface buffer, the only copy made.
+	*/
+	template<int BufferTokenCapacity = PACKETBUFFER_TOKENCOUNT>
+	class PacketInterface_ASCIIMap : public PacketInterface_ASCIISized<BufferTokenCapacity>
+	{
+	protected:
+		PacketFileMap	FileMap;
+
+	public:
+		PacketInterface_ASCIIMap(const char* filePath) :
+			PacketInterface_ASCIISized<BufferTokenCapacity>((std::istream*)nullptr), FileMap(filePath) { ; }
+
+		bool DeSerializePacket()
+		{
+			struct PacketFrame rxFrame;
+			int numCharsFramed;
+			while (FileMap.getReadCount() > 0)
+			{
+				this->FramesCharsPtr = (char*)FileMap.getReadPtr();
+				if (this->FramePackets_ASCII(this, this->FramesCharsPtr, FileMap.getReadCount(), &rxFrame, 1, &numCharsFramed) == 0)
+				{
+					FileMap.Consume(numCharsFramed);
+					if (numCharsFramed == 0)
+						return false;
+					continue;
+				}
+				FileMap.Consume(numCharsFramed);
+				if (this->SlotFramePacket(&rxFrame))
+					return true;
+			}
+			return false;
+		}
+		PacketFileMap*	getFileMap() { return &FileMap; }
+	};
+
+	/*! @}*/
+}
+
+#endif // !__PACKETINTERFACEPOSIX__
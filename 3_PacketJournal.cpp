@@ -0,0 +1,363 @@
+#include "3_PacketJournal.h"
+using namespace IMSPacketsAPICore;
+
+#define PACKETJOURNAL_MAGIC			"IMSPJNL"
+#define PACKETJOURNAL_INDEXMAGIC	"IMSPIDX"
+#define PACKETJOURNAL_BLOCKMAGIC	(0x4B4C4250u)	// "PBLK" in host byte order
+#define PACKETJOURNAL_BYTEORDERMARK	(0x01020304u)
+#define PACKETJOURNAL_VERSION		(1u)
+
+// records are padded so each record header is aligned to 8 bytes
+static inline int	paddedRecordBytes(int numBytes) { return (int)sizeof(struct PacketJournalRecordHeader) + ((numBytes + 7) & ~7); }
+
+static void	writeFileHeader(std::ostream* StreamPtr, const char* magicPtr, uint32_t tokenSize)
+{
+	struct PacketJournalFileHeader FileHeader;
+	memset(&FileHeader, 0, sizeof(FileHeader));
+	memcpy(FileHeader.Magic, magicPtr, sizeof(FileHeader.Magic));
+	FileHeader.ByteOrderMark = PACKETJOURNAL_BYTEORDERMARK;
+	FileHeader.Version = PACKETJOURNAL_VERSION;
+	FileHeader.TokenSize = tokenSize;
+	StreamPtr->write((const char*)&FileHeader, sizeof(FileHeader));
+}
+
+static bool	readFileHeader(std::istream* StreamPtr, const char* magicPtr, struct PacketJournalFileHeader* FileHeaderPtr)
+{
+	StreamPtr->clear();
+	StreamPtr->seekg(0);
+	StreamPtr->read((char*)FileHeaderPtr, sizeof(*FileHeaderPtr));
+	return (StreamPtr->gcount() == (std::streamsize)sizeof(*FileHeaderPtr)
+		&& memcmp(FileHeaderPtr->Magic, magicPtr, sizeof(FileHeaderPtr->Magic)) == 0
+		&& FileHeaderPtr->ByteOrderMark == PACKETJOURNAL_BYTEORDERMARK
+		&& FileHeaderPtr->Version == PACKETJOURNAL_VERSION);
+}
+
+
+#pragma region PacketJournalWriter Implementation
+PacketJournalWriter::PacketJournalWriter(std::ostream* JournalStreamIn, std::ostream* IndexStreamIn, int TokenSizeIn)
+{
+	JournalStream = JournalStreamIn;
+	IndexStream = IndexStreamIn;
+	ResetBlock();
+
+	// appending to an existing journal continues after its last block
+	if (JournalStream != nullptr)
+	{
+		JournalStream->seekp(0, std::ios::end);
+		std::streamoff endOffset = JournalStream->tellp();
+		if (endOffset <= 0)
+		{
+			writeFileHeader(JournalStream, PACKETJOURNAL_MAGIC, (uint32_t)TokenSizeIn);
+			JournalOffset = sizeof(struct PacketJournalFileHeader);
+		}
+		else
+			JournalOffset = (uint64_t)endOffset;
+	}
+	if (IndexStream != nullptr)
+	{
+		IndexStream->seekp(0, std::ios::end);
+		if (IndexStream->tellp() <= 0)
+			writeFileHeader(IndexStream, PACKETJOURNAL_INDEXMAGIC, (uint32_t)TokenSizeIn);
+	}
+}
+PacketJournalWriter::~PacketJournalWriter()
+{
+	FlushBlock();
+}
+
+void	PacketJournalWriter::ResetBlock()
+{
+	memset(&BlockHeader, 0, sizeof(BlockHeader));
+	BlockHeader.Magic = PACKETJOURNAL_BLOCKMAGIC;
+}
+
+uint64_t	PacketJournalWriter::getWallMicros()
+{
+	return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+bool	PacketJournalWriter::Append(const uint8_t* bytesPtr, int numBytes, uint32_t packetKey, uint64_t micros)
+{
+	struct PacketJournalRecordHeader RecordHeader;
+	int recordBytes;
+	if (JournalStream == nullptr || bytesPtr == nullptr || numBytes <= 0)
+		return false;
+	recordBytes = paddedRecordBytes(numBytes);
+	if (recordBytes > PACKETJOURNAL_BLOCKSIZE)
+		return false;
+	if ((int)BlockHeader.PayloadBytes + recordBytes > PACKETJOURNAL_BLOCKSIZE && !FlushBlock())
+		return false;
+
+	// time never decreases, blocks stay ordered for seeking by time
+	if (micros < LastMicros)
+		micros = LastMicros;
+	LastMicros = micros;
+
+	RecordHeader.Micros = micros;
+	RecordHeader.PacketKey = packetKey;
+	RecordHeader.Length = (uint32_t)numBytes;
+	memcpy(&BlockBytes[BlockHeader.PayloadBytes], &RecordHeader, sizeof(RecordHeader));
+	memcpy(&BlockBytes[BlockHeader.PayloadBytes + sizeof(RecordHeader)], bytesPtr, numBytes);
+	memset(&BlockBytes[BlockHeader.PayloadBytes + sizeof(RecordHeader) + numBytes], 0, recordBytes - sizeof(RecordHeader) - numBytes);
+
+	if (BlockHeader.RecordCount++ == 0)
+		BlockHeader.FirstMicros = micros;
+	BlockHeader.LastMicros = micros;
+	BlockHeader.KeyBits[(packetKey >> 6) & 3] |= ((uint64_t)1 << (packetKey & 63));
+	BlockHeader.PayloadBytes += (uint32_t)recordBytes;
+	return true;
+}
+
+bool	PacketJournalWriter::FlushBlock()
+{
+	struct PacketJournalIndexEntry IndexEntry;
+	if (JournalStream == nullptr)
+		return false;
+	if (BlockHeader.RecordCount > 0)
+	{
+		JournalStream->write((const char*)&BlockHeader, sizeof(BlockHeader));
+		JournalStream->write((const char*)BlockBytes, BlockHeader.PayloadBytes);
+		if (!JournalStream->good())
+			return false;
+
+		// the index entry follows its block, an index never refers past the journal
+		if (IndexStream != nullptr)
+		{
+			IndexEntry.BlockOffset = JournalOffset;
+			IndexEntry.Block = BlockHeader;
+			IndexStream->write((const char*)&IndexEntry, sizeof(IndexEntry));
+		}
+		JournalOffset += sizeof(BlockHeader) + BlockHeader.PayloadBytes;
+		ResetBlock();
+	}
+	JournalStream->flush();
+	if (IndexStream != nullptr)
+		IndexStream->flush();
+	return JournalStream->good();
+}
+#pragma endregion
+
+#pragma region PacketJournalReader Implementation
+PacketJournalReader::PacketJournalReader(std::istream* JournalStreamIn, std::istream* IndexStreamIn)
+{
+	struct PacketJournalFileHeader IndexHeader;
+	JournalStream = JournalStreamIn;
+	IndexStream = IndexStreamIn;
+	memset(&FileHeader, 0, sizeof(FileHeader));
+	memset(&BlockHeader, 0, sizeof(BlockHeader));
+	if (JournalStream == nullptr)
+		return;
+	isValid = readFileHeader(JournalStream, PACKETJOURNAL_MAGIC, &FileHeader);
+
+	// a sidecar of another journal, or none, is not used
+	if (IndexStream != nullptr && !(readFileHeader(IndexStream, PACKETJOURNAL_INDEXMAGIC, &IndexHeader) && IndexHeader.TokenSize == FileHeader.TokenSize))
+		IndexStream = nullptr;
+	Rewind();
+}
+
+int		PacketJournalReader::getNumIndexedBlocks()
+{
+	std::streamoff endOffset;
+	if (IndexStream == nullptr)
+		return -1;
+	IndexStream->clear();
+	IndexStream->seekg(0, std::ios::end);
+	endOffset = IndexStream->tellg();
+	if (endOffset < (std::streamoff)sizeof(struct PacketJournalFileHeader))
+		return 0;
+	// a partially written last entry is not counted
+	return (int)((endOffset - sizeof(struct PacketJournalFileHeader)) / sizeof(struct PacketJournalIndexEntry));
+}
+
+bool	PacketJournalReader::isKeyInBlock(const struct PacketJournalBlockHeader* BlockHeaderPtr, uint32_t packetKey)
+{
+	return ((BlockHeaderPtr->KeyBits[(packetKey >> 6) & 3] >> (packetKey & 63)) & 1) != 0;
+}
+
+bool	PacketJournalReader::ReadBlockHeaderAt(uint64_t blockOffset, struct PacketJournalBlockHeader* BlockHeaderPtr)
+{
+	JournalStream->clear();
+	JournalStream->seekg((std::streamoff)blockOffset);
+	JournalStream->read((char*)BlockHeaderPtr, sizeof(*BlockHeaderPtr));
+	return (JournalStream->gcount() == (std::streamsize)sizeof(*BlockHeaderPtr)
+		&& BlockHeaderPtr->Magic == PACKETJOURNAL_BLOCKMAGIC
+		&& BlockHeaderPtr->PayloadBytes <= PACKETJOURNAL_BLOCKSIZE);
+}
+
+bool	PacketJournalReader::ReadIndexEntry(int entryIndex, struct PacketJournalIndexEntry* IndexEntryPtr)
+{
+	IndexStream->clear();
+	IndexStream->seekg((std::streamoff)(sizeof(struct PacketJournalFileHeader) + (size_t)entryIndex * sizeof(struct PacketJournalIndexEntry)));
+	IndexStream->read((char*)IndexEntryPtr, sizeof(*IndexEntryPtr));
+	return (IndexStream->gcount() == (std::streamsize)sizeof(*IndexEntryPtr));
+}
+
+// read a whole block into the block buffer, positioned at its first record
+bool	PacketJournalReader::LoadBlock(int blockIndex, uint64_t blockOffset)
+{
+	RecordsRead = 0;
+	RecordOffset = 0;
+	if (!ReadBlockHeaderAt(blockOffset, &BlockHeader))
+	{
+		BlockHeader.RecordCount = 0;
+		return false;
+	}
+	JournalStream->read((char*)BlockBytes, BlockHeader.PayloadBytes);
+	if (JournalStream->gcount() != (std::streamsize)BlockHeader.PayloadBytes)
+	{
+		// a block still being written is not read
+		BlockHeader.RecordCount = 0;
+		return false;
+	}
+	BlockIndex = blockIndex;
+	NextBlockOffset = blockOffset + sizeof(BlockHeader) + BlockHeader.PayloadBytes;
+	return true;
+}
+
+// load the block after the buffered block, skipping blocks without a key by their index entries, or headers
+bool	PacketJournalReader::LoadNextBlock(bool isKeyFiltered, uint32_t packetKey)
+{
+	struct PacketJournalIndexEntry IndexEntry;
+	int nextIndex = BlockIndex + 1;
+	uint64_t nextOffset = NextBlockOffset;
+	if (!isValid)
+		return false;
+
+	if (IndexStream != nullptr)
+	{
+		while (ReadIndexEntry(nextIndex, &IndexEntry))
+		{
+			if (!isKeyFiltered || isKeyInBlock(&IndexEntry.Block, packetKey))
+				return LoadBlock(nextIndex, IndexEntry.BlockOffset);
+			nextIndex++;
+		}
+		// blocks written after the last index entry are found by their headers
+		if (nextIndex > 0 && ReadIndexEntry(nextIndex - 1, &IndexEntry))
+			nextOffset = IndexEntry.BlockOffset + sizeof(IndexEntry.Block) + IndexEntry.Block.PayloadBytes;
+	}
+
+	struct PacketJournalBlockHeader NextHeader;
+	while (ReadBlockHeaderAt(nextOffset, &NextHeader))
+	{
+		if (!isKeyFiltered || isKeyInBlock(&NextHeader, packetKey))
+			return LoadBlock(nextIndex, nextOffset);
+		nextIndex++;
+		nextOffset += sizeof(NextHeader) + NextHeader.PayloadBytes;
+	}
+	return false;
+}
+
+// the header of the record at the record offset, a record overrunning the block is corrupt and ends the block
+bool	PacketJournalReader::ReadRecordHeader(struct PacketJournalRecordHeader* RecordHeaderPtr)
+{
+	uint32_t remainingBytes = BlockHeader.PayloadBytes - (uint32_t)RecordOffset;
+	if ((uint32_t)RecordOffset > BlockHeader.PayloadBytes || remainingBytes < sizeof(*RecordHeaderPtr))
+	{
+		RecordsRead = BlockHeader.RecordCount;
+		return false;
+	}
+	memcpy(RecordHeaderPtr, &BlockBytes[RecordOffset], sizeof(*RecordHeaderPtr));
+	if (RecordHeaderPtr->Length > remainingBytes - sizeof(*RecordHeaderPtr)
+		|| (uint32_t)paddedRecordBytes((int)RecordHeaderPtr->Length) > remainingBytes)
+	{
+		RecordsRead = BlockHeader.RecordCount;
+		return false;
+	}
+	return true;
+}
+
+bool	PacketJournalReader::Rewind()
+{
+	BlockIndex = -1;
+	NextBlockOffset = sizeof(struct PacketJournalFileHeader);
+	BlockHeader.RecordCount = 0;
+	RecordsRead = 0;
+	RecordOffset = 0;
+	return isValid;
+}
+
+bool	PacketJournalReader::SeekTime(uint64_t micros)
+{
+	struct PacketJournalIndexEntry IndexEntry;
+	struct PacketJournalRecordHeader RecordHeader;
+	int numBlocks = getNumIndexedBlocks();
+	if (!Rewind())
+		return false;
+
+	// the first indexed block ending at or after the time, by binary search of the sidecar
+	if (numBlocks > 0)
+	{
+		int lowIndex = 0;
+		int highIndex = numBlocks;
+		while (lowIndex < highIndex)
+		{
+			int midIndex = lowIndex + (highIndex - lowIndex) / 2;
+			if (!ReadIndexEntry(midIndex, &IndexEntry))
+				return false;
+			if (IndexEntry.Block.LastMicros < micros)
+				lowIndex = midIndex + 1;
+			else
+				highIndex = midIndex;
+		}
+		BlockIndex = lowIndex - 1;
+		if (lowIndex > 0 && ReadIndexEntry(lowIndex - 1, &IndexEntry))
+			NextBlockOffset = IndexEntry.BlockOffset + sizeof(IndexEntry.Block) + IndexEntry.Block.PayloadBytes;
+	}
+
+	// otherwise, or past the index, by block headers
+	do
+	{
+		if (!LoadNextBlock(false, 0))
+			return false;
+	} while (BlockHeader.LastMicros < micros);
+
+	while (RecordsRead < BlockHeader.RecordCount && ReadRecordHeader(&RecordHeader))
+	{
+		if (RecordHeader.Micros >= micros)
+			return true;
+		RecordOffset += paddedRecordBytes((int)RecordHeader.Length);
+		RecordsRead++;
+	}
+	// past a corrupt record, the next block holds the later records
+	return LoadNextBlock(false, 0);
+}
+
+bool	PacketJournalReader::NextRecord(struct PacketJournalRecord* RecordPtr)
+{
+	struct PacketJournalRecordHeader RecordHeader;
+	while (RecordsRead >= BlockHeader.RecordCount)
+		if (!LoadNextBlock(false, 0))
+			return false;
+
+	// a corrupt record ends its block
+	if (!ReadRecordHeader(&RecordHeader))
+		return NextRecord(RecordPtr);
+	RecordPtr->Micros = RecordHeader.Micros;
+	RecordPtr->PacketKey = RecordHeader.PacketKey;
+	RecordPtr->Length = (int)RecordHeader.Length;
+	RecordPtr->BytesPtr = &BlockBytes[RecordOffset + sizeof(RecordHeader)];
+	RecordOffset += paddedRecordBytes((int)RecordHeader.Length);
+	RecordsRead++;
+	return true;
+}
+
+bool	PacketJournalReader::NextRecordOfKey(uint32_t packetKey, struct PacketJournalRecord* RecordPtr)
+{
+	for (;;)
+	{
+		// the rest of a block without the key is skipped
+		if (RecordsRead >= BlockHeader.RecordCount || !isKeyInBlock(&BlockHeader, packetKey))
+		{
+			if (!LoadNextBlock(true, packetKey))
+				return false;
+		}
+		while (RecordsRead < BlockHeader.RecordCount)
+		{
+			if (!NextRecord(RecordPtr))
+				return false;
+			if (RecordPtr->PacketKey == packetKey)
+				return true;
+		}
+	}
+}
+#pragma endregion
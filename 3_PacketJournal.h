@@ -0,0 +1,214 @@
+/*! \file 3_PacketJournal.h
+	\brief Indexed Append-Only Packet Journals
+	\sa APINodeLink
+*/
+#ifndef __PACKETJOURNAL__
+#define __PACKETJOURNAL__
+#include "3_APINodeLink.h"
+
+namespace IMSPacketsAPICore
+{
+	/*! \addtogroup APINodeLink
+		@{
+	*/
+
+	/*! \struct PacketJournalFileHeader
+		\brief First bytes of a journal file, and of its index sidecar
+
+		Journals are written in host byte order, ByteOrderMark reads 0x01020304 on a host of the
+		same byte order.  TokenSize is the binary token size of the journaled packets, 0 for ASCII.
+	*/
+	struct PacketJournalFileHeader
+	{
+		char		Magic[8];
+		uint32_t	ByteOrderMark;
+		uint32_t	Version;
+		uint32_t	TokenSize;
+		uint32_t	Reserved;
+	};
+
+	/*! \struct PacketJournalBlockHeader
+		\brief Header of a block of records, also the entry of a block in the index sidecar
+
+		KeyBits has bit (PacketKey % 256) set for every record of the block, so a reader skips
+		blocks without a packet by reading headers only, or index entries only.
+	*/
+	struct PacketJournalBlockHeader
+	{
+		uint32_t	Magic;
+		uint32_t	RecordCount;
+		uint32_t	PayloadBytes;		// record bytes following the header
+		uint32_t	Reserved;
+		uint64_t	FirstMicros;
+		uint64_t	LastMicros;
+		uint64_t	KeyBits[4];
+	};
+
+	/*! \struct PacketJournalIndexEntry
+		\brief Entry of the index sidecar, a block header and the journal offset of the block
+	*/
+	struct PacketJournalIndexEntry
+	{
+		uint64_t							BlockOffset;
+		struct PacketJournalBlockHeader		Block;
+	};
+
+	/*! \struct PacketJournalRecordHeader
+		\brief Header of a journaled packet, its bytes follow, padded to 8 bytes
+	*/
+	struct PacketJournalRecordHeader
+	{
+		uint64_t	Micros;
+		uint32_t	PacketKey;
+		uint32_t	Length;
+	};
+
+	/*! \struct PacketJournalRecord
+		\brief A journaled packet read in place from the block buffer of a reader
+	*/
+	struct PacketJournalRecord
+	{
+		uint64_t		Micros;
+		uint32_t		PacketKey;
+		int				Length;
+		const uint8_t*	BytesPtr;
+	};
+
+	/*! \class PacketJournalWriter
+		\brief Appends timestamped packets to a journal in blocks, and an entry per block to an index sidecar
+
+		A journal is a file header followed by blocks, each a block header and its records.  Records are
+		buffered in one block and written with the block header in one write.  The index sidecar, when
+		given, is a file header followed by an index entry per block, appended as each block is written,
+		so both files are append-only and readable up to their last complete block.
+
+		PacketKey is the packet ID of binary packets, and the ID string hash (Packet::IDStringHash) of
+		ASCII packets.  Timestamps are microseconds since the epoch, clamped to never decrease, so blocks
+		are in time order for the reader's binary search.  The last block is written when the writer is
+		destroyed, so its streams must outlive it.
+	*/
+	class PacketJournalWriter
+	{
+	protected:
+		std::ostream*					JournalStream;
+		std::ostream*					IndexStream;
+		uint64_t						JournalOffset	= 0;
+		uint64_t						LastMicros		= 0;
+		struct PacketJournalBlockHeader	BlockHeader;
+		alignas(8) uint8_t				BlockBytes[PACKETJOURNAL_BLOCKSIZE];
+
+		void			ResetBlock();
+
+	public:
+		PacketJournalWriter(std::ostream* JournalStreamIn, std::ostream* IndexStreamIn, int TokenSizeIn);
+		~PacketJournalWriter();
+
+		bool			Append(const uint8_t* bytesPtr, int numBytes, uint32_t packetKey, uint64_t micros);
+		//! Write the records buffered so far as a block, then flush the streams
+		bool			FlushBlock();
+		static uint64_t	getWallMicros();
+	};
+
+	/*! \class PacketJournalReader
+		\brief Reads a journal by time or packet key, seeking by its index sidecar when given
+
+		Without a sidecar, blocks are found by reading their headers only and seeking past their records.
+		Records are read in place from the block buffer of the reader, and are valid until the next read.
+	*/
+	class PacketJournalReader
+	{
+	protected:
+		std::istream*					JournalStream;
+		std::istream*					IndexStream;
+		struct PacketJournalFileHeader	FileHeader;
+		bool							isValid				= false;
+		struct PacketJournalBlockHeader	BlockHeader;
+		alignas(8) uint8_t				BlockBytes[PACKETJOURNAL_BLOCKSIZE];
+		int								BlockIndex			= -1;	// index of the buffered block
+		uint64_t						NextBlockOffset		= 0;
+		uint32_t						RecordsRead			= 0;
+		int								RecordOffset		= 0;
+
+		static bool		isKeyInBlock(const struct PacketJournalBlockHeader* BlockHeaderPtr, uint32_t packetKey);
+		bool			ReadBlockHeaderAt(uint64_t blockOffset, struct PacketJournalBlockHeader* BlockHeaderPtr);
+		bool			ReadIndexEntry(int entryIndex, struct PacketJournalIndexEntry* IndexEntryPtr);
+		bool			LoadBlock(int blockIndex, uint64_t blockOffset);
+		bool			LoadNextBlock(bool isKeyFiltered, uint32_t packetKey);
+		bool			ReadRecordHeader(struct PacketJournalRecordHeader* RecordHeaderPtr);
+
+	public:
+		PacketJournalReader(std::istream* JournalStreamIn, std::istream* IndexStreamIn = nullptr);
+
+		inline bool		isJournal() { return isValid; }
+		inline int		getTokenSize() { return (int)FileHeader.TokenSize; }
+		//! The number of blocks in the index sidecar, -1 without one
+		int				getNumIndexedBlocks();
+
+		bool			Rewind();
+		/*! \fn SeekTime
+			\brief Position the reader at the first record at or after a time
+			\return False if there is none
+		*/
+		bool			SeekTime(uint64_t micros);
+		bool			NextRecord(struct PacketJournalRecord* RecordPtr);
+		//! Read the next record of a packet key, skipping blocks without it
+		bool			NextRecordOfKey(uint32_t packetKey, struct PacketJournalRecord* RecordPtr);
+	};
+
+	/*! \class PacketInterface_BinaryJournal
+		\brief Binary output interface journaling every packet written, for a PacketPort_FileSystem
+	*/
+	template<class TokenType, int TokenCapacity = PACKETBUFFER_TOKENCOUNT>
+	class PacketInterface_BinaryJournal : public PacketInterface_Binary<TokenType, TokenCapacity>
+	{
+	protected:
+		PacketJournalWriter		Journal;
+
+		void	CustomWriteTo()
+		{
+			// the key is the packet ID in host byte order
+			TokenType idToken;
+			memcpy(&idToken, &this->TokenBuffer.bytes[0], sizeof(TokenType));
+			if (this->isWireByteOrderSwapped())
+				Packet::swapTokenByteOrder((uint8_t*)&idToken, 1, sizeof(TokenType));
+			Journal.Append(&this->TokenBuffer.bytes[0], this->serializedPacketSize, (uint32_t)idToken.uintVal, PacketJournalWriter::getWallMicros());
+		}
+		void	CustomFlushTo() { Journal.FlushBlock(); }
+
+	public:
+		PacketInterface_BinaryJournal(std::ostream* JournalStreamIn, std::ostream* IndexStreamIn = nullptr) :
+			PacketInterface_Binary<TokenType, TokenCapacity>((std::ostream*)nullptr), Journal(JournalStreamIn, IndexStreamIn, sizeof(TokenType)) { ; }
+
+		PacketJournalWriter*	getJournal() { return &Journal; }
+	};
+
+	/*! \class PacketInterface_ASCIIJournal
+		\brief ASCII output interface journaling every packet written, for a PacketPort_FileSystem
+	*/
+	template<int BufferTokenCapacity = PACKETBUFFER_TOKENCOUNT>
+	class PacketInterface_ASCIIJournal : public PacketInterface_ASCIISized<BufferTokenCapacity>
+	{
+	protected:
+		PacketJournalWriter		Journal;
+
+		void	CustomWriteTo()
+		{
+			// the key is the hash of the ID string, up to its delimiter
+			char idSlot[STRINGBUFFER_IDTOKENRATIO] = { 0 };
+			int idLength = Packet::scanTokenBoundary(this->TokenChars, STRINGBUFFER_IDTOKENRATIO - 1);
+			memcpy(idSlot, this->TokenChars, idLength);
+			Journal.Append((const uint8_t*)this->TokenChars, this->serializedPacketSize, Packet::IDStringHash(idSlot), PacketJournalWriter::getWallMicros());
+		}
+		void	CustomFlushTo() { Journal.FlushBlock(); }
+
+	public:
+		PacketInterface_ASCIIJournal(std::ostream* JournalStreamIn, std::ostream* IndexStreamIn = nullptr) :
+			PacketInterface_ASCIISized<BufferTokenCapacity>((std::ostream*)nullptr), Journal(JournalStreamIn, IndexStreamIn, 0) { ; }
+
+		PacketJournalWriter*	getJournal() { return &Journal; }
+	};
+
+	/*! @}*/
+}
+
+#endif // !__PACKETJOURNAL__
@@ -39,6 +39,13 @@ namespace IMSPacketsAPICore
 
 		TEMPLATE_SPDACCESSORS_H(PacketType)
 		TEMPLATE_SPDACCESSORS_H(PacketOption)
+
+		TEMPLATE_SPDFIELD_H(PacketType, iHDRPACK_PacketType, typeINT)
+		TEMPLATE_SPDFIELD_H(PacketOption, iHDRPACK_PacketOption, typeINT)
+
+		TEMPLATE_SPDSTRUCT_H(pSTRUCT(HDRPACK),
+			SPDSTRUCTMEMBER(pSTRUCT(HDRPACK), PackType, PacketType),
+			SPDSTRUCTMEMBER(pSTRUCT(HDRPACK), PackOpt, PacketOption))
 	};
 }
 
@@ -42,6 +42,17 @@ namespace IMSPacketsAPICore
 		TEMPLATE_SPDACCESSORS_H(BuildNumber)
 		TEMPLATE_SPDACCESSORS_H(DevFlag)
 
+		TEMPLATE_SPDFIELD_H(MajorVersion, iVERSION_Major, typeINT)
+		TEMPLATE_SPDFIELD_H(MinorVersion, iVERSION_Minor, typeINT)
+		TEMPLATE_SPDFIELD_H(BuildNumber, iVERSION_Build, typeINT)
+		TEMPLATE_SPDFIELD_H(DevFlag, iVERSION_Dev, typeINT)
+
+		TEMPLATE_SPDSTRUCT_H(pSTRUCT(VERSION),
+			SPDSTRUCTMEMBER(pSTRUCT(VERSION), Major, MajorVersion),
+			SPDSTRUCTMEMBER(pSTRUCT(VERSION), Minor, MinorVersion),
+			SPDSTRUCTMEMBER(pSTRUCT(VERSION), Build, BuildNumber),
+			SPDSTRUCTMEMBER(pSTRUCT(VERSION), DevFlag, DevFlag))
+
 	};
 }
 #endif // !__PACKET_VERSION__
\ No newline at end of file
@@ -0,0 +1,140 @@
+#include "3_PortExecutor.h"
+using namespace IMSPacketsAPICore;
+
+
+#pragma region PortExecutor Implementation
+PortExecutor::PortExecutor(int numWorkersIn)
+{
+	NumWorkers = (numWorkersIn < 1) ? 1 : ((numWorkersIn > PORTEXECUTOR_WORKERCOUNT) ? PORTEXECUTOR_WORKERCOUNT : numWorkersIn);
+	isRunningFlag.store(false, std::memory_order_relaxed);
+	for (int i = 0; i < PORTEXECUTOR_WORKERCOUNT; i++)
+	{
+		Workers[i].Cycles.store(0, std::memory_order_relaxed);
+		Workers[i].BusyMicros.store(0, std::memory_order_relaxed);
+		Workers[i].ElapsedMicros.store(0, std::memory_order_relaxed);
+		Workers[i].MaxCycleMicros.store(0, std::memory_order_relaxed);
+	}
+}
+PortExecutor::~PortExecutor()
+{
+	Stop();
+}
+
+uint64_t	PortExecutor::getMonotonicMicros()
+{
+	return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool	PortExecutor::AddPort(PolymorphicPacketPort* PortPtr, int workerIndex)
+{
+	if (PortPtr == nullptr || !PortPtr->getAsyncService() || isRunning() || workerIndex < -1 || workerIndex >= NumWorkers)
+		return false;
+
+	// a port is pinned to one worker only
+	for (int i = 0; i < NumWorkers; i++)
+		for (int j = 0; j < Workers[i].NumPorts; j++)
+			if (Workers[i].Ports[j] == PortPtr)
+				return false;
+
+	if (workerIndex == -1)
+	{
+		workerIndex = 0;
+		for (int i = 1; i < NumWorkers; i++)
+			if (Workers[i].NumPorts < Workers[workerIndex].NumPorts)
+				workerIndex = i;
+	}
+	if (Workers[workerIndex].NumPorts >= PORTEXECUTOR_PORTCAPACITY)
+		return false;
+
+	Workers[workerIndex].Ports[Workers[workerIndex].NumPorts++] = PortPtr;
+	return true;
+}
+int		PortExecutor::AddNodePorts(API_NODE* NodePtr)
+{
+	int numAdded = 0;
+	if (NodePtr != nullptr)
+		for (int i = 0; i < NodePtr->getNumPacketPorts(); i++)
+			if (AddPort(NodePtr->getPacketPortat(i)))
+				numAdded++;
+	return numAdded;
+}
+
+void	PortExecutor::setCyclePeriodMicros(int cyclePeriodMicrosIn)
+{
+	CyclePeriodMicros = (cyclePeriodMicrosIn > 0) ? cyclePeriodMicrosIn : 0;
+}
+
+bool	PortExecutor::Start()
+{
+	if (isRunning())
+		return false;
+	isRunningFlag.store(true, std::memory_order_release);
+	for (int i = 0; i < NumWorkers; i++)
+	{
+		Workers[i].Cycles.store(0, std::memory_order_relaxed);
+		Workers[i].BusyMicros.store(0, std::memory_order_relaxed);
+		Workers[i].ElapsedMicros.store(0, std::memory_order_relaxed);
+		Workers[i].MaxCycleMicros.store(0, std::memory_order_relaxed);
+		// ports are added before start, a worker without ports would only spin
+		if (Workers[i].NumPorts > 0)
+			Workers[i].Thread = std::thread(&PortExecutor::RunWorker, this, &Workers[i]);
+	}
+	return true;
+}
+void	PortExecutor::Stop()
+{
+	isRunningFlag.store(false, std::memory_order_release);
+	for (int i = 0; i < NumWorkers; i++)
+		if (Workers[i].Thread.joinable())
+			Workers[i].Thread.join();
+}
+
+void	PortExecutor::RunWorker(struct PortWorker* WorkerPtr)
+{
+	// statistics are written by the worker only, and read by any thread
+	uint64_t startMicros = getMonotonicMicros();
+	uint64_t busyMicros = 0;
+	uint64_t maxCycleMicros = 0;
+	uint64_t numCycles = 0;
+	while (isRunningFlag.load(std::memory_order_acquire))
+	{
+		uint64_t cycleMicros = getMonotonicMicros();
+		for (int i = 0; i < WorkerPtr->NumPorts; i++)
+			WorkerPtr->Ports[i]->ServicePort();
+		uint64_t endMicros = getMonotonicMicros();
+
+		busyMicros += endMicros - cycleMicros;
+		if (endMicros - cycleMicros > maxCycleMicros)
+			maxCycleMicros = endMicros - cycleMicros;
+		WorkerPtr->Cycles.store(++numCycles, std::memory_order_relaxed);
+		WorkerPtr->BusyMicros.store(busyMicros, std::memory_order_relaxed);
+		WorkerPtr->ElapsedMicros.store(endMicros - startMicros, std::memory_order_relaxed);
+		WorkerPtr->MaxCycleMicros.store(maxCycleMicros, std::memory_order_relaxed);
+
+		if (CyclePeriodMicros > 0 && endMicros - cycleMicros < (uint64_t)CyclePeriodMicros)
+			std::this_thread::sleep_for(std::chrono::microseconds(CyclePeriodMicros - (int)(endMicros - cycleMicros)));
+		else
+			std::this_thread::yield();
+	}
+	WorkerPtr->ElapsedMicros.store(getMonotonicMicros() - startMicros, std::memory_order_relaxed);
+}
+
+bool	PortExecutor::getWorkerStats(int workerIndex, struct PortWorkerStats* StatsPtr)
+{
+	if (workerIndex < 0 || workerIndex >= NumWorkers || StatsPtr == nullptr)
+		return false;
+	StatsPtr->NumPorts = Workers[workerIndex].NumPorts;
+	StatsPtr->Cycles = Workers[workerIndex].Cycles.load(std::memory_order_relaxed);
+	StatsPtr->BusyMicros = Workers[workerIndex].BusyMicros.load(std::memory_order_relaxed);
+	StatsPtr->ElapsedMicros = Workers[workerIndex].ElapsedMicros.load(std::memory_order_relaxed);
+	StatsPtr->MaxCycleMicros = Workers[workerIndex].MaxCycleMicros.load(std::memory_order_relaxed);
+	return true;
+}
+float	PortExecutor::getWorkerLoad(int workerIndex)
+{
+	struct PortWorkerStats workerStats;
+	if (!getWorkerStats(workerIndex, &workerStats) || workerStats.ElapsedMicros == 0)
+		return 0.0f;
+	return (float)workerStats.BusyMicros / (float)workerStats.ElapsedMicros;
+}
+#pragma endregion
@@ -0,0 +1,102 @@
+/*! \file 3_PortExecutor.h
+	\brief Threaded Service of Asynchronous Packet Ports
+	\sa APINodeLink
+
+	For nodes with a standard thread library.  Ports constructed with isAsync are skipped by
+	API_NODE::ServiceSynchronousPorts, a PortExecutor services them on its own worker threads.
+*/
+#ifndef __PORTEXECUTOR__
+#define __PORTEXECUTOR__
+#include <thread>		// std::thread, ahead of the str() macro of LanguageConstructs
+#include "3_APINodeLink.h"
+
+namespace IMSPacketsAPICore
+{
+	/*! \addtogroup APINodeLink
+		@{
+	*/
+
+	/*! \struct PortWorkerStats
+		\brief Load statistics of a worker of a port executor, since it was started
+
+		BusyMicros is the time spent servicing ports, ElapsedMicros the time since the worker started,
+		so BusyMicros / ElapsedMicros is the load of the worker.  A cycle services each port of the
+		worker once.
+	*/
+	struct PortWorkerStats
+	{
+		int			NumPorts;
+		uint64_t	Cycles;
+		uint64_t	BusyMicros;
+		uint64_t	ElapsedMicros;
+		uint64_t	MaxCycleMicros;
+	};
+
+	/*! \class PortExecutor
+		\brief Services asynchronous packet ports on a pool of worker threads
+
+		Each port is pinned to one worker, which alone calls its ServicePort(), so the state machine
+		of a port keeps single threaded semantics.  Ports are added before the executor is started, to
+		the worker with the fewest ports unless a worker is given.  Workers service their ports in
+		cycles, and sleep out the remainder of the cycle period, PORTEXECUTOR_CYCLEPERIODMICROS by default.
+		With a period of 0 they yield between cycles, and spin a core each.  Workers without ports are not started.
+
+		Stop() lets every worker complete its cycle, then joins it.  Data execution handlers of a port
+		run on its worker, application threads exchange packets with it through its output lanes.  Handlers
+		and application threads then both enqueue, so the lanes of an added port must be multi-producer,
+		as the default lanes are.
+	*/
+	class PortExecutor
+	{
+	protected:
+		struct PortWorker
+		{
+			std::thread					Thread;
+			PolymorphicPacketPort*		Ports[PORTEXECUTOR_PORTCAPACITY];
+			int							NumPorts		= 0;
+			std::atomic<uint64_t>		Cycles;
+			std::atomic<uint64_t>		BusyMicros;
+			std::atomic<uint64_t>		ElapsedMicros;
+			std::atomic<uint64_t>		MaxCycleMicros;
+		};
+
+		struct PortWorker		Workers[PORTEXECUTOR_WORKERCOUNT];
+		int						NumWorkers;
+		int						CyclePeriodMicros	= PORTEXECUTOR_CYCLEPERIODMICROS;
+		std::atomic<bool>		isRunningFlag;
+
+		static uint64_t	getMonotonicMicros();
+		void			RunWorker(struct PortWorker* WorkerPtr);
+
+	public:
+		//! An executor of numWorkersIn workers, at least 1 and at most PORTEXECUTOR_WORKERCOUNT
+		PortExecutor(int numWorkersIn);
+		~PortExecutor();
+
+		/*! \fn AddPort
+			\brief Pin an asynchronous port to a worker, the worker with the fewest ports if workerIndex is -1
+			\return False if the executor is running, the port is synchronous, or the worker is full
+		*/
+		bool		AddPort(PolymorphicPacketPort* PortPtr, int workerIndex = -1);
+		//! Add every asynchronous port of a node, \return the number added
+		int			AddNodePorts(API_NODE* NodePtr);
+
+		//! Sleep out the remainder of each worker cycle, 0 yields between cycles and spins a core per worker
+		void		setCyclePeriodMicros(int cyclePeriodMicrosIn);
+
+		//! Start the workers with ports and reset their statistics, false if running
+		bool		Start();
+		//! Stop the workers after their current cycle, and join them
+		void		Stop();
+		inline bool	isRunning() { return isRunningFlag.load(std::memory_order_acquire); }
+
+		inline int	getNumWorkers() { return NumWorkers; }
+		bool		getWorkerStats(int workerIndex, struct PortWorkerStats* StatsPtr);
+		//! BusyMicros / ElapsedMicros of a worker, 0 before it has run
+		float		getWorkerLoad(int workerIndex);
+	};
+
+	/*! @}*/
+}
+
+#endif // !__PORTEXECUTOR__